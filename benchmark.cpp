@@ -0,0 +1,123 @@
+#include "mandelbrot.h"
+#include "run.h"
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Benchmark program: times the rendering algorithms on the views of the catalog (run.h) and writes the results as CSV
+// and JSON, so that results of different builds can be compared
+// It is a separate program from the window (main.cpp), built from all files except main.cpp and render.cpp
+
+// Function to split a comma separated list
+static vector<string> split(const string& list) {
+    vector<string> items;
+    stringstream stream(list);
+    string item;
+    while(getline(stream, item, ',')) {
+        if(!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+// Function to print how the program is used
+static void usage(const char* program) {
+    cerr << "Usage: " << program << " [options]\n"
+         << "  --viewports LIST   views to render (default all: home,seahorse-valley,deep-minibrot,all-interior)\n"
+         << "  --kernels LIST     algorithms to time (default all: auto,unoptimized,optimized,periodic,continuous,\n"
+         << "                     histogram,vectorized,subdivision,perturbation,distance)\n"
+         << "  --threads LIST     thread counts (default 0, one per core)\n"
+         << "  --iterations LIST  max numbers of iterations (default that of every view)\n"
+         << "  --size WxH         size of the renderings (default 512x512)\n"
+         << "  --warmup N         untimed renderings before the timed ones (default 2)\n"
+         << "  --runs N           timed renderings (default 10)\n"
+         << "  --seed N           seed of the color palette (default 1)\n"
+         << "  --csv PATH         CSV output (default benchmark.csv)\n"
+         << "  --json PATH        JSON output (default benchmark.json)\n";
+}
+
+int main(int argc, char** argv) {
+    benchmark_options options;
+    string csv = "benchmark.csv";
+    string json = "benchmark.json";
+
+    // Reading the options
+    for(int k = 1; k < argc; k ++) {
+        string option = argv[k];
+        if(k + 1 >= argc) {
+            usage(argv[0]);
+            return 1;
+        }
+        string value = argv[++ k];
+        vector<string> items = split(value);
+        if(option == "--viewports") {
+            for(size_t i = 0; i < items.size(); i ++) {
+                bool found = false;
+                for(int v = 0; v < BENCHMARK_VIEWPORT_COUNT; v ++) {
+                    if(items[i] == BENCHMARK_VIEWPORTS[v].name) found = true;
+                }
+                if(!found) {
+                    cerr << "Unknown viewport " << items[i] << "\n";
+                    return 1;
+                }
+            }
+            options.viewports = items;
+        }
+        else if(option == "--kernels") {
+            options.kernels.clear();
+            for(size_t i = 0; i < items.size(); i ++) {
+                int found = -1;
+                for(int a = AUTO; a <= DISTANCE; a ++) {
+                    if(items[i] == algorithm_name((algorithm_type)a)) found = a;
+                }
+                if(found < 0) {
+                    cerr << "Unknown kernel " << items[i] << "\n";
+                    return 1;
+                }
+                options.kernels.push_back((algorithm_type)found);
+            }
+        }
+        else if(option == "--threads" || option == "--iterations") {
+            vector<int>& numbers = option == "--threads" ? options.threads : options.iterations;
+            numbers.clear();
+            for(size_t i = 0; i < items.size(); i ++) numbers.push_back(atoi(items[i].c_str()));
+        }
+        else if(option == "--size") {
+            if(sscanf(value.c_str(), "%dx%d", &options.width, &options.height) != 2) options.width = 0;
+        }
+        else if(option == "--warmup") options.warmup = atoi(value.c_str());
+        else if(option == "--runs") options.runs = atoi(value.c_str());
+        else if(option == "--seed") options.seed = strtoul(value.c_str(), NULL, 10);
+        else if(option == "--csv") csv = value;
+        else if(option == "--json") json = value;
+        else {
+            cerr << "Unknown option " << option << "\n";
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if(options.width <= 0 || options.height <= 0 || options.runs <= 0 || options.warmup < 0 || options.threads.empty()) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    vector<benchmark_result> results = runBenchmarks(options);
+    if(!writeBenchmarkCsv(csv, options, results) || !writeBenchmarkJson(json, options, results)) {
+        cerr << "Cannot write the results\n";
+        return 1;
+    }
+
+    // Table of the results
+    printf("%-16s %-13s %-14s %7s %10s %10s %10s %10s %12s\n", "viewport", "kernel", "scalar", "threads", "iterations",
+           "p10 (ms)", "median", "p90", "Mpoints/s");
+    for(size_t k = 0; k < results.size(); k ++) {
+        const benchmark_result& result = results[k];
+        printf("%-16s %-13s %-14s %7d %10d %10.3f %10.3f %10.3f %12.2f\n", result.viewport.c_str(),
+               algorithm_name(result.kernel), result.scalar.c_str(), result.threads, result.max_iteration,
+               result.p10 * 1000, result.median * 1000, result.p90 * 1000, result.points_per_second / 1e6);
+    }
+    return 0;
+}
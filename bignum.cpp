@@ -0,0 +1,228 @@
+#include "bignum.h"
+#include <algorithm>
+#include <cmath>
+using namespace std;
+
+// Value of a limb (2^32)
+static const double LIMB = 4294967296.0;
+
+big_number::big_number(int fraction_limbs) {
+    negative = false;
+    limbs.assign(fraction_limbs + 1, 0);
+}
+
+big_number::big_number(double value, int fraction_limbs) {
+    negative = value < 0;
+    limbs.assign(fraction_limbs + 1, 0);
+    value = fabs(value);
+
+    // Integer part, then 32 bits of the fraction at a time (multiplying by 2^32 is exact for doubles)
+    double integer = floor(value);
+    limbs[0] = (uint32_t) integer;
+    double fraction = value - integer;
+    for(int k = 1; k <= fraction_limbs && fraction > 0; k ++) {
+        fraction *= LIMB;
+        double limb = floor(fraction);
+        limbs[k] = (uint32_t) limb;
+        fraction -= limb;
+    }
+}
+
+big_number::big_number(const string& value, int fraction_limbs) {
+    negative = false;
+    limbs.assign(fraction_limbs + 1, 0);
+
+    size_t pos = 0;
+    if(pos < value.size() && (value[pos] == '-' || value[pos] == '+')) {
+        negative = value[pos] == '-';
+        pos ++;
+    }
+    // Integer part
+    uint32_t integer = 0;
+    while(pos < value.size() && isdigit(value[pos])) {
+        integer = integer * 10 + (value[pos] - '0');
+        pos ++;
+    }
+    // Fractional digits d1 d2 ... dm are added from the last one, as f = (f + d) / 10 at each step
+    if(pos < value.size() && value[pos] == '.') {
+        size_t start = pos + 1;
+        size_t end = start;
+        while(end < value.size() && isdigit(value[end])) end ++;
+        for(size_t k = end; k > start; k --) {
+            limbs[0] = value[k - 1] - '0';
+            // Long division of all limbs by 10, from the most significant one
+            uint64_t remainder = 0;
+            for(size_t l = 0; l < limbs.size(); l ++) {
+                uint64_t current = (remainder << 32) | limbs[l];
+                limbs[l] = (uint32_t)(current / 10);
+                remainder = current % 10;
+            }
+        }
+    }
+    limbs[0] = integer;
+}
+
+int big_number::precision() const {
+    return limbs.size() - 1;
+}
+
+void big_number::set_precision(int fraction_limbs) {
+    limbs.resize(fraction_limbs + 1, 0);
+}
+
+double big_number::to_double() const {
+    // Adding the limbs from the least significant one, so that small limbs are not lost
+    double value = 0;
+    for(size_t k = limbs.size(); k > 0; k --) {
+        value = value / LIMB + limbs[k - 1];
+    }
+    return negative ? -value : value;
+}
+
+unsigned long long big_number::hash() const {
+    // Trailing zero limbs do not change the value, so they are left out
+    size_t n = limbs.size();
+    while(n > 1 && limbs[n - 1] == 0) n --;
+    bool zero = n == 1 && limbs[0] == 0;
+    // FNV-1a hash of the sign and the limbs
+    unsigned long long h = 14695981039346656037ULL;
+    h = (h ^ (negative && !zero ? 1 : 0)) * 1099511628211ULL;
+    for(size_t k = 0; k < n; k ++) {
+        h = (h ^ limbs[k]) * 1099511628211ULL;
+    }
+    return h;
+}
+
+big_number big_number::round_down(int exponent) const {
+    big_number result = *this;
+    if(exponent < 0) result.set_precision(max(precision(), (-exponent + 31) / 32));
+
+    // Bit b of limb k is worth 2^(b - 32k), so the bits of limb k below 2^exponent are its exponent + 32k lowest bits
+    bool cleared = false;
+    for(size_t k = 0; k < result.limbs.size(); k ++) {
+        int bits = min(max(exponent + 32 * (int)k, 0), 32);
+        uint32_t mask = bits == 32 ? 0 : ~(uint32_t)0 << bits;
+        if(result.limbs[k] & ~mask) cleared = true;
+        result.limbs[k] &= mask;
+    }
+    // Magnitudes are truncated, which rounds negative numbers up, so they go down by one more multiple
+    if(result.negative && cleared) result = result - big_number(ldexp(1.0, exponent), result.precision());
+    return result;
+}
+
+string big_number::to_string(int digits) const {
+    string result = negative ? "-" : "";
+    result += std::to_string(limbs[0]) + ".";
+    // Multiplying the fraction by 10 moves its next decimal digit into the integer part
+    vector<uint32_t> fraction(limbs.begin() + 1, limbs.end());
+    for(int d = 0; d < digits; d ++) {
+        uint64_t carry = 0;
+        for(size_t l = fraction.size(); l > 0; l --) {
+            uint64_t current = (uint64_t)fraction[l - 1] * 10 + carry;
+            fraction[l - 1] = (uint32_t) current;
+            carry = current >> 32;
+        }
+        result += (char)('0' + carry);
+    }
+    return result;
+}
+
+int big_number::compare_magnitude(const big_number& a, const big_number& b) {
+    for(size_t k = 0; k < a.limbs.size(); k ++) {
+        if(a.limbs[k] != b.limbs[k]) return a.limbs[k] < b.limbs[k] ? -1 : 1;
+    }
+    return 0;
+}
+
+void big_number::add_magnitude(const big_number& a, const big_number& b, big_number& result) {
+    uint64_t carry = 0;
+    for(size_t k = a.limbs.size(); k > 0; k --) {
+        uint64_t sum = (uint64_t)a.limbs[k - 1] + b.limbs[k - 1] + carry;
+        result.limbs[k - 1] = (uint32_t) sum;
+        carry = sum >> 32;
+    }
+}
+
+void big_number::sub_magnitude(const big_number& a, const big_number& b, big_number& result) {
+    int64_t borrow = 0;
+    for(size_t k = a.limbs.size(); k > 0; k --) {
+        int64_t difference = (int64_t)a.limbs[k - 1] - b.limbs[k - 1] - borrow;
+        borrow = difference < 0;
+        if(difference < 0) difference += (int64_t)1 << 32;
+        result.limbs[k - 1] = (uint32_t) difference;
+    }
+}
+
+big_number big_number::add(const big_number& a, const big_number& b, bool subtract) {
+    // Both numbers are brought to the same precision
+    int n = max(a.precision(), b.precision());
+    big_number x = a;
+    big_number y = b;
+    x.set_precision(n);
+    y.set_precision(n);
+    if(subtract) y.negative = !y.negative;
+
+    big_number result(n);
+    // Same signs: magnitudes are added, else the smaller magnitude is subtracted from the larger one
+    if(x.negative == y.negative) {
+        add_magnitude(x, y, result);
+        result.negative = x.negative;
+    }
+    else if(compare_magnitude(x, y) >= 0) {
+        sub_magnitude(x, y, result);
+        result.negative = x.negative;
+    }
+    else {
+        sub_magnitude(y, x, result);
+        result.negative = y.negative;
+    }
+    return result;
+}
+
+big_number big_number::operator+(const big_number& b) const {
+    return add(*this, b, false);
+}
+
+big_number big_number::operator-(const big_number& b) const {
+    return add(*this, b, true);
+}
+
+big_number big_number::operator-() const {
+    big_number result = *this;
+    result.negative = !negative;
+    return result;
+}
+
+big_number big_number::operator*(const big_number& b) const {
+    int n = max(precision(), b.precision());
+    big_number x = *this;
+    big_number y = b;
+    x.set_precision(n);
+    y.set_precision(n);
+
+    // Schoolbook multiplication of the n + 1 limbs of both numbers, from the least significant limbs
+    // Limb k of x times limb l of y is worth 2^(-32(k + l)), so it goes to position k + l of the 2n + 1 limb product
+    vector<uint32_t> product(2 * n + 1, 0);
+    for(int k = n; k >= 0; k --) {
+        uint64_t carry = 0;
+        for(int l = n; l >= 0; l --) {
+            uint64_t current = (uint64_t)x.limbs[k] * y.limbs[l] + product[k + l] + carry;
+            product[k + l] = (uint32_t) current;
+            carry = current >> 32;
+        }
+        // Carry out of position k goes to position k - 1 (lost for k = 0, but the product is small)
+        if(k > 0) product[k - 1] += (uint32_t) carry;
+    }
+
+    // Keeping the integer part and the first n fractional limbs (the rest is truncated)
+    big_number result(n);
+    for(int k = 0; k <= n; k ++) result.limbs[k] = product[k];
+    result.negative = x.negative != y.negative;
+    return result;
+}
+
+int limbs_for_spacing(double spacing) {
+    // Bits needed below the spacing, plus 64 guard bits, rounded up to limbs (at least 2 limbs)
+    int bits = (int) ceil(-log2(spacing)) + 64;
+    return max(2, (bits + 31) / 32);
+}
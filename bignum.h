@@ -0,0 +1,59 @@
+#ifndef __BIGNUM_H__
+#define __BIGNUM_H__
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Arbitrary precision fixed point number, used for the center of the view in deep zooms
+// (doubles cannot tell apart points closer than about 1e-16 times their size)
+// Numbers have a sign, a 32-bit integer part, and any number of 32-bit fractional limbs, so a number with
+// n fractional limbs is exact to 2^(-32n); points of the Mandelbrot Set and their orbits (till they escape) are small,
+// so the integer part never overflows
+class big_number {
+
+private:
+    // Whether the number is negative
+    bool negative;
+    // limbs[0] is the integer part, and limbs[k] (k >= 1) is the k-th fractional limb (worth 2^(-32k))
+    vector<uint32_t> limbs;
+
+    // Functions to compare, add and subtract the absolute values of numbers with the same number of limbs
+    // (sub_magnitude requires |a| >= |b|)
+    static int compare_magnitude(const big_number& a, const big_number& b);
+    static void add_magnitude(const big_number& a, const big_number& b, big_number& result);
+    static void sub_magnitude(const big_number& a, const big_number& b, big_number& result);
+    // Function to add numbers of any sign (b is subtracted if subtract is true)
+    static big_number add(const big_number& a, const big_number& b, bool subtract);
+
+public:
+    // Constructor (0, with the given number of fractional limbs)
+    big_number(int fraction_limbs = 2);
+    // Constructor from a double (exact, if fraction_limbs is large enough)
+    big_number(double value, int fraction_limbs);
+    // Constructor from a decimal string such as "-0.743643887037158704752191506114774"
+    big_number(const string& value, int fraction_limbs);
+    // Function to return the number of fractional limbs
+    int precision() const;
+    // Function to change the number of fractional limbs (extra limbs are 0, removed limbs are truncated)
+    void set_precision(int fraction_limbs);
+    // Function to return the nearest double (approximately)
+    double to_double() const;
+    // Function to return the number as a decimal string with the given number of digits after the point
+    string to_string(int digits) const;
+    // Function to return a hash of the value (equal numbers have equal hashes, whatever their precision)
+    unsigned long long hash() const;
+    // Function to round the number down to a multiple of 2^exponent (exponent < 32; the precision is increased if the
+    // number cannot hold the multiples of 2^exponent)
+    big_number round_down(int exponent) const;
+    // Arithmetic operations (result has the larger precision of the two numbers, and is truncated to it)
+    big_number operator+(const big_number& b) const;
+    big_number operator-(const big_number& b) const;
+    big_number operator*(const big_number& b) const;
+    big_number operator-() const;
+};
+
+// Function to return the number of fractional limbs needed to tell apart points which are spacing apart
+// (with enough extra bits for the rounding errors of a reference orbit)
+int limbs_for_spacing(double spacing);
+#endif // __BIGNUM_H__
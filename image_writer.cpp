@@ -0,0 +1,142 @@
+#include "image_writer.h"
+
+// Largest length of a stored deflate block
+static const size_t STORED_BLOCK = 65535;
+
+// CRC-32 (used by PNG chunks) of bytes, continuing from crc
+static uint32_t crc32_update(uint32_t crc, const unsigned char* bytes, size_t length) {
+    // Table of the CRC of every byte value, found once
+    static uint32_t table[256];
+    static bool have_table = false;
+    if(!have_table) {
+        for(uint32_t n = 0; n < 256; n ++) {
+            uint32_t c = n;
+            for(int k = 0; k < 8; k ++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            table[n] = c;
+        }
+        have_table = true;
+    }
+    crc = ~crc;
+    for(size_t k = 0; k < length; k ++) {
+        crc = table[(crc ^ bytes[k]) & 255] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+image_writer::image_writer() {
+    png = false;
+    width = height = 0;
+    rows_written = 0;
+    adler_a = 1;
+    adler_b = 0;
+}
+
+void image_writer::put_u32(uint32_t value) {
+    unsigned char bytes[4] = {(unsigned char)(value >> 24), (unsigned char)(value >> 16), (unsigned char)(value >> 8), (unsigned char)value};
+    chunk.insert(chunk.end(), bytes, bytes + 4);
+}
+
+void image_writer::put_bytes(const unsigned char* bytes, size_t length) {
+    chunk.insert(chunk.end(), bytes, bytes + length);
+}
+
+void image_writer::write_chunk(const char* type) {
+    // Length of the data, then the type and the data, then the CRC of the type and the data
+    vector<unsigned char> data;
+    data.swap(chunk);
+    put_u32(data.size());
+    put_bytes((const unsigned char*)type, 4);
+    put_bytes(data.empty() ? NULL : &data[0], data.size());
+    uint32_t crc = crc32_update(0, &chunk[4], chunk.size() - 4);
+    put_u32(crc);
+    out.write((const char*)&chunk[0], chunk.size());
+    chunk.clear();
+}
+
+bool image_writer::open(const string& path, int width, int height) {
+    this -> width = width;
+    this -> height = height;
+    rows_written = 0;
+    png = path.size() >= 4 && path.compare(path.size() - 4, 4, ".png") == 0;
+    out.open(path.c_str(), ios::out | ios::binary);
+    if(!out) return false;
+
+    if(png) {
+        const unsigned char signature[8] = {137, 'P', 'N', 'G', 13, 10, 26, 10};
+        out.write((const char*)signature, 8);
+        // Header: size, 8 bits per channel, RGB, no interlacing
+        put_u32(width);
+        put_u32(height);
+        const unsigned char format[5] = {8, 2, 0, 0, 0};
+        put_bytes(format, 5);
+        write_chunk("IHDR");
+        // zlib header (deflate with a 32K window, no preset dictionary), at the start of the image data
+        const unsigned char zlib_header[2] = {0x78, 0x01};
+        put_bytes(zlib_header, 2);
+        adler_a = 1;
+        adler_b = 0;
+    }
+    else out << "P6\n" << width << " " << height << "\n255\n";
+    return (bool)out;
+}
+
+void image_writer::write_rows(const sf::Color* pixels, int rows) {
+    rows = min(rows, height - rows_written);
+    if(rows <= 0) return;
+
+    // Rows as RGB bytes, each of them starting with its filter type (0, none) in PNG
+    size_t row_bytes = 3 * (size_t)width + (png ? 1 : 0);
+    vector<unsigned char> data(row_bytes * rows);
+    for(int j = 0; j < rows; j ++) {
+        unsigned char* row = &data[j * row_bytes];
+        if(png) *row ++ = 0;
+        for(int i = 0; i < width; i ++) {
+            const sf::Color& c = pixels[(size_t)j * width + i];
+            row[3 * i] = c.r;
+            row[3 * i + 1] = c.g;
+            row[3 * i + 2] = c.b;
+        }
+    }
+    rows_written += rows;
+
+    if(!png) {
+        out.write((const char*)&data[0], data.size());
+        return;
+    }
+
+    // Adler-32 of the data (sums are reduced at least every 5552 bytes, so they cannot overflow)
+    for(size_t k = 0; k < data.size(); ) {
+        size_t end = min(data.size(), k + 5552);
+        for(; k < end; k ++) {
+            adler_a += data[k];
+            adler_b += adler_a;
+        }
+        adler_a %= 65521;
+        adler_b %= 65521;
+    }
+    // Data split into stored (uncompressed) blocks, all in one chunk
+    // None of them is the last block, which is added (empty) by close
+    for(size_t k = 0; k < data.size(); k += STORED_BLOCK) {
+        size_t length = min(STORED_BLOCK, data.size() - k);
+        unsigned char header[5] = {0, (unsigned char)length, (unsigned char)(length >> 8), (unsigned char)~length, (unsigned char)(~length >> 8)};
+        put_bytes(header, 5);
+        put_bytes(&data[k], length);
+    }
+    write_chunk("IDAT");
+}
+
+bool image_writer::close() {
+    bool complete = rows_written == height;
+    if(png) {
+        // Empty last stored block, and the Adler-32 checksum ending the zlib stream
+        const unsigned char last_block[5] = {1, 0, 0, 0xFF, 0xFF};
+        put_bytes(last_block, 5);
+        put_u32((adler_b << 16) | adler_a);
+        write_chunk("IDAT");
+        write_chunk("IEND");
+    }
+    out.close();
+    return complete && !out.fail();
+}
@@ -0,0 +1,45 @@
+#ifndef __IMAGE_WRITER_H__
+#define __IMAGE_WRITER_H__
+#include <SFML/Graphics.hpp>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Writer of an RGB image in PPM (binary, P6) or PNG format, which is given a few rows at a time and writes them to the
+// file right away, so images much larger than the memory can be written
+// PNG images are not compressed (the zlib stream is made of stored blocks), so no compression library is needed
+class image_writer {
+
+private:
+    // File being written
+    ofstream out;
+    // Whether the format is PNG (else PPM)
+    bool png;
+    // Size of the image, and number of rows written so far
+    int width;
+    int height;
+    int rows_written;
+    // Running Adler-32 checksum of the uncompressed PNG data (two 16-bit sums)
+    uint32_t adler_a;
+    uint32_t adler_b;
+    // Bytes of the current PNG chunk (written at once, since its length comes before its data)
+    vector<unsigned char> chunk;
+
+    // Functions to add to the current chunk a 32-bit big-endian number, and bytes, and to write it as a chunk of a type
+    void put_u32(uint32_t value);
+    void put_bytes(const unsigned char* bytes, size_t length);
+    void write_chunk(const char* type);
+
+public:
+    // Constructor (no file is open)
+    image_writer();
+    // Function to start an image (PNG if path ends with ".png", else PPM); returns false if the file cannot be written
+    bool open(const string& path, int width, int height);
+    // Function to write the next rows of the image (width * rows colors, row by row; the alpha channel is dropped)
+    void write_rows(const sf::Color* pixels, int rows);
+    // Function to finish the image; returns false if not all rows were written or the file could not be written
+    bool close();
+};
+#endif // __IMAGE_WRITER_H__
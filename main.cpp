@@ -1,6 +1,7 @@
 #include <SFML/Graphics.hpp>
 #include "stack.h"
 #include "mandelbrot.h"
+#include "render_service.h"
 #include "run.h"
 #include <time.h>
 #include <random>
@@ -9,8 +10,31 @@
 #include <vector>
 #include <string>
 #include <chrono>
+#include <sstream>
 using namespace std;
 
+// Function to write the telemetry of a rendering as the lines of the overlay
+string telemetry_string(const telemetry_report& report) {
+    if(!report.enabled) return "Telemetry is disabled (build with MANDELBROT_TELEMETRY)";
+    ostringstream out;
+    out.precision(3);
+    long long points = report.escaped + report.cycles + report.bailed + report.interior + report.reused + report.filled;
+    if(points <= 0) points = 1;
+    out << "Iterations: " << report.iterations / 1e6 << " M\n";
+    out << "Escaped " << 100.0 * report.escaped / points << "%, periodic " << 100.0 * report.cycles / points
+        << "%, bailed out " << 100.0 * report.bailed / points << "%\n";
+    out << "Interior check " << 100.0 * report.interior / points << "%, reused " << 100.0 * report.reused / points
+        << "%, filled " << 100.0 * report.filled / points << "%\n";
+    out << "Total " << report.total_seconds * 1000 << " ms:";
+    for(int k = 0; k < TELEMETRY_PHASES; k ++) {
+        out << " " << telemetry_phase_name((telemetry_phase)k) << " " << report.phase_seconds[k] * 1000;
+    }
+    out << "\n";
+    out << "Tiles: " << report.tiles << ", mean " << report.mean_tile_seconds * 1000 << " ms, slowest "
+        << report.slowest_tile_seconds * 1000 << " ms at (" << report.slowest_tile_x << ", " << report.slowest_tile_y << ")";
+    return out.str();
+}
+
 int main()
 {
     /*
@@ -33,14 +57,33 @@ int main()
     int precision = 100;
 
     MandelbrotSet* m = new MandelbrotSet(p, width, height, q, r, s, precision);
+    // Coarse previews are shown while a rendering is in progress
+    m -> set_progressive(true);
+    // Points shared with the previous rendering are reused after zooming in or panning
+    m -> set_reprojection(true);
+    // Renderings with the AUTO algorithm show a first frame within 50 ms (refined in the background if it is not final)
+    m -> set_time_budget(0.05);
 
     sf::RenderWindow window(sf::VideoMode(width, height), "Mandelbrot Set");
-    // Creating an initial Mandelbrot Set and depicting it on the window
-    m -> Algorithm(true);
+    // Last completed rendering taken from the render service (initially only its zoom and precision are known)
+    render_frame shown;
+    shown.zoom = m -> get_zoom();
+    shown.precision = m -> get_precision();
+    // All renderings are done by the render service on a background thread, so the window keeps handling events
+    // From now on the Set is only used through the service
+    render_service service(m, width, height);
+    // Creating an initial Mandelbrot Set (depicted on the window once it is completed)
+    service.render();
+
+    // Texture holding the current rendering, drawn as a single sprite
+    // It is updated from the framebuffer of the Set only when the rendering has changed
+    sf::Texture texture;
+    texture.create(width, height);
+    sf::Sprite sprite(texture);
 
     // Various text and button elements implemented below
 
-    // Text to show current zoom level (restricted to lie in [1, 62])
+    // Text to show current zoom level (number of times zoomed in)
     sf::Text text;
     // Font used is BRITANIC.ttf, which must be present in the parent directory
     sf::Font font;
@@ -49,7 +92,7 @@ int main()
     }
 
     // Setting various features of the text (such as font, font size, color, bold and position on the screen)
-    string zoom_string = to_string(m -> get_zoom()) + "x";
+    string zoom_string = to_string(shown.zoom) + "x";
     text.setFont(font);
     text.setString(zoom_string);
     text.setCharacterSize(60);
@@ -61,13 +104,34 @@ int main()
     sf::Text precision_text;
     // Setting various features of the text (such as font, font size, color, bold and position on the screen)
     precision_text.setFont(font);
-    string precision_string = to_string(m -> get_precision() / 10) + "%";
+    string precision_string = to_string(shown.precision / 10) + "%";
     precision_text.setString(precision_string);
     precision_text.setCharacterSize(60);
     precision_text.setFillColor(sf::Color::Red);
     precision_text.setStyle(sf::Text::Bold);
     precision_text.setPosition(10.0f, 90.0f);
 
+    // Text to show the progress of the rendering in progress (empty when there is none)
+    sf::Text progress_text;
+    // Setting various features of the text (such as font, font size, color, bold and position on the screen)
+    progress_text.setFont(font);
+    progress_text.setCharacterSize(30);
+    progress_text.setFillColor(sf::Color::Red);
+    progress_text.setStyle(sf::Text::Bold);
+    progress_text.setPosition(10.0f, 160.0f);
+
+    // Text showing the telemetry of the shown rendering (toggled with the T key; H writes its heatmap to heatmap.png)
+    sf::Text telemetry_text;
+    bool show_telemetry = false;
+    // Whether the Set is rendered with distance estimation (toggled with the D key) instead of the AUTO algorithm
+    bool distance_mode = false;
+    // Setting various features of the text (such as font, font size, color, bold and position on the screen)
+    telemetry_text.setFont(font);
+    telemetry_text.setCharacterSize(18);
+    telemetry_text.setFillColor(sf::Color::Yellow);
+    telemetry_text.setStyle(sf::Text::Bold);
+    telemetry_text.setPosition(10.0f, 210.0f);
+
     // Circular button for zooming out of the Mandelbrot Set
     // Uses the stack to find the previous version, and depicts it on the screen
     sf::CircleShape zoomout;
@@ -192,6 +256,15 @@ int main()
     dec_iter_text2.setFillColor(sf::Color::Red);
     dec_iter_text2.setPosition(dec_iterX + rect_dec_width / 8.0, dec_iterY + rect_dec_height / 2.0);
 
+    // Point where the left mouse button was pressed on the Set (a drag pans the view, a click zooms in)
+    bool dragging = false;
+    int dragX = 0;
+    int dragY = 0;
+    // Movements of the mouse up to this many pixels are still taken as clicks
+    const int drag_threshold = 5;
+    // Arrow keys move the view by an eighth of the window
+    int pan_step = width / 8;
+
     while (window.isOpen())
     {
         // Change all colors back to their initial green values
@@ -335,8 +408,8 @@ int main()
                         color.b = 255;
                         zoomout.setFillColor(color);
 
-                        // Calling zoom out function from the MandelbrotSet class
-                        m -> zoom_out();
+                        // Asking the render service to zoom out
+                        service.zoom_out();
                     }
 
                     // If change palette button was clicked
@@ -355,8 +428,8 @@ int main()
                         r = 2 + rand() % 998;
                         s = 2 + rand() % 998;
 
-                        // Changing color of the palette and re-rendering the image
-                        m -> change_colors(p, q, r, s);
+                        // Changing color of the palette and re-rendering the image (on the render service)
+                        service.change_colors(p, q, r, s);
                     }
 
                     // If increase precision button was clicked
@@ -369,8 +442,8 @@ int main()
                         window.draw(iter_text1);
                         window.draw(iter_text2);
 
-                        // Calling inc precision function from the MandelbrotSet class
-                        m -> inc_precision();
+                        // Asking the render service to increase precision
+                        service.inc_precision();
                     }
 
                     // If decrease precision button was clicked
@@ -383,23 +456,44 @@ int main()
                         window.draw(dec_iter_text1);
                         window.draw(dec_iter_text2);
 
-                        // Calling dec precision function from the MandelbrotSet class
-                        m -> dec_precision();
+                        // Asking the render service to decrease precision
+                        service.dec_precision();
                     }
 
-                    // Otherwise the mouse was clicked at some random point in the window
-                    // Then we zoom in (centering at the clicked point) and re-render the image
+                    // Otherwise the mouse was pressed at some random point in the window
+                    // It is a click or a drag, which is known only when the button is released
                     else {
-                        m -> zoom_in(mouseX, mouseY);
-                        m -> Algorithm(true);
+                        dragging = true;
+                        dragX = event.mouseButton.x;
+                        dragY = event.mouseButton.y;
                     }
+                }
+            }
 
-                    // Since click might change zoom or precision values, so re-writing those texts
-                    zoom_string = to_string(m -> get_zoom()) + "x";
-                    text.setString(zoom_string);
+            // Checking for the release of the left mouse button after it was pressed on the Set
+            if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left && dragging) {
+                dragging = false;
+                int dx = event.mouseButton.x - dragX;
+                int dy = event.mouseButton.y - dragY;
+                // If the mouse was dragged, then the view is moved with it (only the newly exposed points are iterated)
+                if(abs(dx) > drag_threshold || abs(dy) > drag_threshold) service.pan(-dx, -dy);
+                // Otherwise we zoom in (centering at the clicked point) and re-render the image
+                // A click during a rendering stops it, and the new rendering starts from its view
+                else service.zoom_in(dragX, dragY);
+            }
 
-                    precision_string = to_string(m -> get_precision() / 10) + "%";
-                    precision_text.setString(precision_string);
+            // Arrow keys move the view, T shows or hides the telemetry, H exports the heatmap and D switches between
+            // distance estimation and the AUTO algorithm
+            if (event.type == sf::Event::KeyPressed) {
+                if(event.key.code == sf::Keyboard::Left) service.pan(-pan_step, 0);
+                else if(event.key.code == sf::Keyboard::Right) service.pan(pan_step, 0);
+                else if(event.key.code == sf::Keyboard::Up) service.pan(0, -pan_step);
+                else if(event.key.code == sf::Keyboard::Down) service.pan(0, pan_step);
+                else if(event.key.code == sf::Keyboard::T) show_telemetry = !show_telemetry;
+                else if(event.key.code == sf::Keyboard::H) service.export_heatmap();
+                else if(event.key.code == sf::Keyboard::D) {
+                    distance_mode = !distance_mode;
+                    service.set_algorithm(distance_mode ? DISTANCE : AUTO);
                 }
             }
 
@@ -407,11 +501,31 @@ int main()
                 window.close();
         }
 
+        // Copying the new completed rendering (if any) to the texture
+        // Since it might change zoom or precision values, so re-writing those texts
+        if(service.take_frame(shown)) {
+            texture.update((const sf::Uint8*) &shown.pixels[0]);
+
+            zoom_string = to_string(shown.zoom) + "x";
+            text.setString(zoom_string);
+
+            precision_string = to_string(shown.precision / 10) + "%";
+            precision_text.setString(precision_string);
+
+            telemetry_text.setString(telemetry_string(shown.telemetry));
+        }
+
+        // Progress of the rendering in progress (if any)
+        if(service.is_busy()) progress_text.setString("Rendering " + to_string((int)(100 * service.get_progress())) + "%");
+        else progress_text.setString("");
+
         // Drawing all elements of the program (such as the Set itself and various texts and buttons)
         window.clear();
-        window.draw(m -> get_points());
+        window.draw(sprite);
         window.draw(text);
         window.draw(precision_text);
+        window.draw(progress_text);
+        if(show_telemetry) window.draw(telemetry_text);
         window.draw(zoomout);
         window.draw(zoomout_text);
         window.draw(colorChange);
@@ -1,8 +1,23 @@
 #include "mandelbrot.h"
+#include "image_writer.h"
 #include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstring>
 using namespace std;
 
+// Default time of an iteration of an algorithm in a scalar type on one thread (in seconds), till the scheduler times it
+static double default_iteration_seconds(algorithm_type algorithm, scalar_type scalar) {
+    // Nanoseconds per iteration of every algorithm (in the order of algorithm_type), in floats
+    static const double nanoseconds[] = {2.7, 4.0, 2.7, 2.3, 3.2, 2.8, 1.2, 1.5, 6.0, 3.5};
+    // Factor of every scalar type (vector instructions take half as many doubles as floats)
+    static const double factors[] = {1, 1, 1, 3, 20, 12};
+    double factor = factors[scalar];
+    if(algorithm == VECTORIZED && scalar == SCALAR_DOUBLE) factor = 2;
+    return nanoseconds[algorithm] * factor * 1e-9;
+}
+
 // Constructor to allocate memory and initialize various member variables
 MandelbrotSet::MandelbrotSet(int p, int width, int height, int q, int r, int s, int max_iteration) {
     // max_iteration, p, width, height taken as input
@@ -17,11 +32,70 @@ MandelbrotSet::MandelbrotSet(int p, int width, int height, int q, int r, int s,
     this -> lim_b = -1.12;
     // Initial zoom level is 1x
     this -> zoom = 1;
+    // Center and size of the view corresponding to these limits
+    this -> center_x = big_number(-0.765, 2);
+    this -> center_y = big_number(0.0, 2);
+    this -> span_x = 2.47;
+    this -> span_y = 2.24;
+    // Algorithm is chosen based on precision, and vectorized algorithm uses the best instruction set available
+    this -> algorithm = AUTO;
+    this -> simd = detect_simd_level();
+    // Scalar type is chosen based on the size of the view
+    this -> scalar = SCALAR_AUTO;
+    this -> last_scalar = SCALAR_DOUBLE;
+    // Points in the main cardioid and period-2 bulb are not iterated
+    this -> interior_check = true;
+    this -> interior_skipped = 0;
+    this -> filled = 0;
+    this -> rebases = 0;
+    // Distance estimation fills the points which are far enough outside the Set
+    this -> distance_filling = true;
+    // Perturbation algorithm skips the first iterations of all points with the series approximation
+    this -> series_approximation = true;
+    this -> series_skipped = 0;
+    // Renderings run till they are finished, unless they are cancelled
+    this -> cancel_requested = false;
+    this -> work_done = 0;
+    this -> work_total = 0;
+    // Renderings are shown only when they are finished
+    this -> progressive = false;
+    // Every rendering iterates all points
+    this -> reprojection = false;
+    this -> reprojection_tolerance = REPROJECTION_TOLERANCE;
+    this -> have_previous = false;
+    this -> reusing = false;
+    this -> reprojected = false;
+    this -> reused_points = 0;
+    this -> cached_points = 0;
+    // Tiles of renderings are cached (64 MB by default)
+    this -> cache_enabled = true;
+    this -> caching = false;
+    // Cycle detection is used only by the periodic algorithm, and periods of points are not saved
+    this -> cycle_detection = false;
+    this -> tolerance = 0;
+    this -> period_output = false;
+    // Renderings have no time budget, and the cost model starts from the default costs
+    this -> time_budget = 0;
+    for(int a = AUTO; a <= DISTANCE; a ++) {
+        for(int t = SCALAR_AUTO; t <= SCALAR_FIXED128; t ++) {
+            iteration_seconds[a][t] = default_iteration_seconds((algorithm_type)a, (scalar_type)t);
+        }
+    }
+    this -> quick_algorithm = AUTO;
+    this -> predicted_time = 0;
 
-    // VertexArray points consists elements of type sf::Points
-    // Size of the array is same as area of window
-    points.setPrimitiveType(sf::Points);
-    points.resize(width * height);
+    // Framebuffer has one RGBA8 color per point of the window, stored row by row (as needed by sf::Texture)
+    framebuffer.resize(width * height);
+    dirty = false;
+    // Buffers of iteration counts (and their fractional parts for continuous coloring) have one element per point
+    iterations.resize(width * height);
+    fractions.resize(width * height);
+    distances.resize(width * height);
+    coloring = ESCAPE_COLORING;
+    have_iterations = false;
+    rendered_max_iteration = max_iteration;
+    orbits_algorithm = AUTO;
+    have_orbits = false;
 
     // Creating color palette (consisting of p colors)
     // Uses p, and random variables q, r, s
@@ -44,6 +118,7 @@ MandelbrotSet::MandelbrotSet(int p, int width, int height, int q, int r, int s,
         cz = cz % 256;
         palette.push_back(sf::Color(cx, cy, cz));
     }
+    this -> interpolate_palette();
 }
 
 // Change color palette with respect to the new values of p, q, r, s
@@ -69,16 +144,33 @@ void MandelbrotSet::change_colors(int p, int q, int r, int s) {
         cz = cz % 256;
         palette.push_back(sf::Color(cx, cy, cz));
     }
+    this -> interpolate_palette();
 
     // Remove the topmost plot from the stack (that was the plot before changing the colors)
     st.pop();
-    // Re-render the Mandelbrot Set and add this new plot to the stack
-    this -> Algorithm(true);
+
+    // If iteration counts of the current plot are known, then only the colors have to be found again
+    if(have_iterations) {
+        this -> recolor();
+        this -> save_rendering(true);
+    }
+    // Else re-render the Mandelbrot Set and add this new plot to the stack
+    else this -> Algorithm(true);
+}
+
+// Function to make the framebuffer publicly available (width * height RGBA8 colors, row by row)
+const sf::Uint8* MandelbrotSet::get_pixels() {
+    return (const sf::Uint8*) &framebuffer[0];
 }
 
-// Function to make points array publicly available
-sf::VertexArray MandelbrotSet::get_points() {
-    return points;
+// Function to check whether the framebuffer has changed since it was last shown
+bool MandelbrotSet::is_dirty() {
+    return dirty;
+}
+
+// Function to mark the framebuffer as shown
+void MandelbrotSet::clear_dirty() {
+    dirty = false;
 }
 
 // Function to get current zoom of the Set
@@ -91,13 +183,332 @@ int MandelbrotSet::get_precision() {
     return max_iteration;
 }
 
+// Change number of threads used for rendering
+void MandelbrotSet::set_threads(int threads) {
+    pool.set_threads(threads);
+}
+
+// Function to get number of threads used for rendering
+int MandelbrotSet::get_threads() {
+    return pool.get_threads();
+}
+
+// Function to get number of renderings saved in the stack
+int MandelbrotSet::get_stack_size() {
+    return st.size();
+}
+
+// Function to get memory used by the renderings saved in the stack (in bytes)
+size_t MandelbrotSet::get_stack_bytes() {
+    return st.bytes();
+}
+
+// Change the memory which can be used by the saved renderings in the stack
+void MandelbrotSet::set_stack_budget(size_t bytes) {
+    st.set_memory_budget(bytes);
+}
+
+// Enable or disable the check for points in the main cardioid or period-2 bulb
+void MandelbrotSet::set_interior_check(bool interior_check) {
+    this -> interior_check = interior_check;
+}
+
+// Function to get number of points which were not iterated (due to interior check) in the last rendering
+long long MandelbrotSet::get_interior_skipped() {
+    return interior_skipped;
+}
+
+// Set the view by its center and its width and height (the plot is not rendered again)
+void MandelbrotSet::set_view(const big_number& x, const big_number& y, double span_x, double span_y) {
+    this -> save_previous();
+    this -> span_x = span_x;
+    this -> span_y = span_y;
+    // Center must have enough precision to tell apart adjacent points
+    int limbs = max(x.precision(), limbs_for_spacing(min(span_x / width, span_y / height)));
+    center_x = x;
+    center_y = y;
+    center_x.set_precision(limbs);
+    center_y.set_precision(limbs);
+    this -> update_limits();
+}
+
+// Function to get the x coordinate of the center of the view
+const big_number& MandelbrotSet::get_center_x() {
+    return center_x;
+}
+
+// Function to get the y coordinate of the center of the view
+const big_number& MandelbrotSet::get_center_y() {
+    return center_y;
+}
+
+// Function to get the width of the view
+double MandelbrotSet::get_span() {
+    return span_x;
+}
+
+// Function to get the height of the view
+double MandelbrotSet::get_span_y() {
+    return span_y;
+}
+
+// Function to get the number of rebases done by the perturbation algorithm in the last rendering
+long long MandelbrotSet::get_rebases() {
+    return rebases;
+}
+
+// Enable or disable the series approximation in the perturbation algorithm
+void MandelbrotSet::set_series_approximation(bool series_approximation) {
+    this -> series_approximation = series_approximation;
+}
+
+// Function to get the number of iterations skipped by the series approximation in the last rendering
+long long MandelbrotSet::get_series_skipped() {
+    return series_skipped;
+}
+
+// Function to get the fraction of points which were filled by the subdivision algorithm or distance estimation in the
+// last rendering
+double MandelbrotSet::get_filled_fraction() {
+    return (double)filled / ((long long)width * height);
+}
+
+// Enable or disable the filling of points by distance estimation
+void MandelbrotSet::set_distance_filling(bool distance_filling) {
+    this -> distance_filling = distance_filling;
+}
+
+// Function to get the distances of the points from the Set
+const vector<float>& MandelbrotSet::get_distances() {
+    return distances;
+}
+
+// Enable or disable cycle detection in all algorithms
+void MandelbrotSet::set_cycle_detection(bool cycle_detection) {
+    this -> cycle_detection = cycle_detection;
+}
+
+// Enable or disable saving of the periods found by cycle detection (and the interior check)
+void MandelbrotSet::set_period_output(bool period_output) {
+    this -> period_output = period_output;
+    if(period_output) periods.assign(width * height, 0);
+    else periods.clear();
+}
+
+// Function to get the periods of all points in the last rendering
+const vector<int>& MandelbrotSet::get_periods() {
+    return periods;
+}
+
+// Function to get the iteration counts of all points in the last rendering
+const vector<int>& MandelbrotSet::get_iterations() {
+    return iterations;
+}
+
+// Function to get the coloring used by the last rendering
+coloring_type MandelbrotSet::get_coloring() {
+    return coloring;
+}
+
+// Use a histogram of iteration counts given by the caller for histogram coloring (empty to use the rendering's own)
+void MandelbrotSet::set_shared_histogram(const vector<long long>& histogram) {
+    shared_histogram = histogram;
+}
+
+// Change the algorithm used for rendering
+void MandelbrotSet::set_algorithm(algorithm_type algorithm) {
+    this -> algorithm = algorithm;
+}
+
+// Function to get the algorithm used for rendering
+algorithm_type MandelbrotSet::get_algorithm() {
+    return algorithm;
+}
+
+// Change the instruction set used by the vectorized algorithm (must be supported by the processor)
+void MandelbrotSet::set_simd_level(simd_level simd) {
+    this -> simd = simd;
+}
+
+// Function to get the instruction set used by the vectorized algorithm
+simd_level MandelbrotSet::get_simd_level() {
+    return simd;
+}
+
+// Change the scalar type used by the optimized, periodic, histogram and vectorized algorithms
+void MandelbrotSet::set_scalar_type(scalar_type scalar) {
+    this -> scalar = scalar;
+}
+
+// Function to get the scalar type used by these algorithms (may be SCALAR_AUTO)
+scalar_type MandelbrotSet::get_scalar_type() {
+    return scalar;
+}
+
+// Function to get the scalar type used by the last rendering
+scalar_type MandelbrotSet::get_last_scalar() {
+    return last_scalar;
+}
+
+// Stop the rendering in progress (tiles which have not started are skipped)
+void MandelbrotSet::request_cancel() {
+    cancel_requested = true;
+}
+
+// Allow renderings to run till they are finished again
+void MandelbrotSet::clear_cancel() {
+    cancel_requested = false;
+}
+
+// Function to check whether renderings are being stopped (i.e. whether the last one was left unfinished)
+bool MandelbrotSet::is_cancelled() {
+    return cancel_requested;
+}
+
+// Function to get the fraction of points done by the rendering in progress
+double MandelbrotSet::get_progress() {
+    long long total = work_total;
+    if(total == 0) return 1;
+    return min(1.0, (double)work_done / total);
+}
+
+// Function to enable or disable progressive rendering
+void MandelbrotSet::set_progressive(bool progressive) {
+    this -> progressive = progressive;
+}
+
+// Function to check whether renderings are progressive
+bool MandelbrotSet::get_progressive() {
+    return progressive;
+}
+
+// Function to set the function called with the preview after each pass of a progressive rendering
+void MandelbrotSet::set_preview_listener(const function<void()>& preview_listener) {
+    this -> preview_listener = preview_listener;
+}
+
+// Function to set the time budget of renderings with the AUTO algorithm
+void MandelbrotSet::set_time_budget(double seconds) {
+    this -> time_budget = seconds;
+}
+
+// Function to get the algorithm of the quick frame of the last scheduled rendering
+algorithm_type MandelbrotSet::get_quick_algorithm() {
+    return quick_algorithm;
+}
+
+// Function to get the predicted time of the last scheduled rendering
+double MandelbrotSet::get_predicted_seconds() {
+    return predicted_time;
+}
+
+// Function to enable or disable the reuse of the previous rendering (it is dropped when reuse is disabled)
+void MandelbrotSet::set_reprojection(bool reprojection) {
+    this -> reprojection = reprojection;
+    if(!reprojection) {
+        have_previous = false;
+        previous = previous_rendering();
+    }
+}
+
+// Function to set the distance (as a fraction of the distance between adjacent points) within which points of the
+// previous rendering are reused
+void MandelbrotSet::set_reprojection_tolerance(double reprojection_tolerance) {
+    this -> reprojection_tolerance = reprojection_tolerance;
+}
+
+// Function to get the fraction of points which reused their iteration count (from the previous rendering or the tile
+// cache) in the last rendering
+double MandelbrotSet::get_reused_fraction() {
+    return (double)(reused_points + cached_points) / ((long long)width * height);
+}
+
+// Function to set the memory budget of the tile cache (tiles are dropped if it is 0)
+void MandelbrotSet::set_cache_budget(size_t bytes) {
+    cache_enabled = bytes > 0;
+    cache.set_memory_budget(bytes);
+}
+
+// Function to get the memory used by the tile cache
+size_t MandelbrotSet::get_cache_bytes() {
+    return cache.bytes();
+}
+
+// Function to get the number of points found in the tile cache
+long long MandelbrotSet::get_cache_hits() {
+    return cache.get_hits();
+}
+
+// Function to get the number of points not found in the tile cache
+long long MandelbrotSet::get_cache_misses() {
+    return cache.get_misses();
+}
+
+// Function to get the telemetry of the last rendering
+telemetry_report MandelbrotSet::get_telemetry() {
+    telemetry_report report;
+    report.interior = interior_skipped;
+    report.reused = reused_points + cached_points;
+    report.filled = filled;
+#ifdef MANDELBROT_TELEMETRY
+    report.enabled = true;
+    report.iterations = telemetry.iterations;
+    report.escaped = telemetry.escaped;
+    report.cycles = telemetry.cycles;
+    report.bailed = telemetry.bailed;
+    for(int k = 0; k < TELEMETRY_PHASES; k ++) report.phase_seconds[k] = telemetry.phase_seconds[k];
+    report.total_seconds = telemetry.total_seconds;
+    // Only tiles which were rendered by the algorithm (not skipped, e.g. by a cancelled rendering) are counted
+    double sum = 0;
+    for(int k = 0; k < (int)telemetry.tile_seconds.size(); k ++) {
+        double seconds = telemetry.tile_seconds[k];
+        if(seconds <= 0) continue;
+        report.tiles ++;
+        sum += seconds;
+        if(seconds > report.slowest_tile_seconds) {
+            report.slowest_tile_seconds = seconds;
+            report.slowest_tile_x = k % telemetry.tiles_x;
+            report.slowest_tile_y = k / telemetry.tiles_x;
+        }
+    }
+    if(report.tiles > 0) report.mean_tile_seconds = sum / report.tiles;
+#endif
+    return report;
+}
+
+// Function to color the iterations done by every point in the last rendering
+void MandelbrotSet::get_heatmap(vector<sf::Color>& colors) {
+    colors.resize(width * height);
+#ifdef MANDELBROT_TELEMETRY
+    if((int)telemetry.point_cost.size() == width * height) {
+        heatmap_colors(&telemetry.point_cost[0], width * height, max_iteration, &colors[0]);
+        return;
+    }
+#endif
+    heatmap_colors(&iterations[0], width * height, max_iteration, &colors[0]);
+}
+
+// Function to write the heatmap of the last rendering to an image
+bool MandelbrotSet::write_heatmap(const string& path) {
+    vector<sf::Color> colors;
+    this -> get_heatmap(colors);
+    image_writer writer;
+    if(!writer.open(path, width, height)) return false;
+    writer.write_rows(&colors[0], height);
+    return writer.close();
+}
+
 // Increase precision (cf. max_iteration) by a value of 100
 void MandelbrotSet::inc_precision() {
     // Precision is increased to a maximum of 1000
     if(max_iteration >= 1000) return;
     max_iteration += 100;
-    // Re-render the set, but do not add this new rendering to the stack
-    this -> Algorithm(false);
+    // If the same algorithm would be used again, then only the saved orbits of points which did not escape are continued
+    // Points which already escaped keep the same iteration counts
+    algorithm_type chosen = chosen_algorithm();
+    if(have_orbits && orbits_algorithm == chosen && last_scalar == chosen_scalar(chosen)) this -> resume_orbits(max_iteration - 100);
+    // Else re-render the set, but do not add this new rendering to the stack
+    else this -> Algorithm(false);
 }
 
 // Decrease precision (cf. max_iteration) by a value of 100
@@ -109,15 +520,72 @@ void MandelbrotSet::dec_precision() {
     this -> Algorithm(false);
 }
 
-// Choosing an algorithm based on the precision level required
+// Choosing an algorithm based on the precision level required (unless some algorithm was selected using set_algorithm)
 // For higher precision, choosing a faster method to get calculation time similar to previous precision
-void MandelbrotSet::Algorithm(bool addToStack) {
+algorithm_type MandelbrotSet::chosen_algorithm() {
+    if(algorithm != AUTO) return algorithm;
+    // In deep zooms, only the perturbation algorithm can tell adjacent points apart
+    if(min(span_x / width, span_y / height) < DEEP_ZOOM_SPACING) return PERTURBATION;
     // If precision is between 10% and 20%, then do histogram coloring (most time consuming)
-    if(max_iteration <= 200) this -> histogramColoring(addToStack);
+    if(max_iteration <= 200) return HISTOGRAM;
     // If precision is between 30% and 40%, then use continuous coloring
-    else if(max_iteration <= 400) this -> continuousColoring(addToStack);
+    if(max_iteration <= 400) return CONTINUOUS;
     // If precision is 50% or above, then use periodic escaping (not as accurate, but highly time-efficient)
-    else this -> periodicallyCheckedEscapeTime(addToStack);
+    return PERIODIC;
+}
+
+// Choosing the cheapest scalar type which can still tell adjacent points of the view apart (unless some type was selected
+// using set_scalar_type): floats at shallow zooms (twice as many points per vector instruction), then doubles,
+// long doubles, fixed point numbers and double-doubles as the view gets smaller
+// (fixed point multiplication is faster than double-double multiplication, which is only needed very close to 0,
+// where double-doubles resolve smaller distances)
+scalar_type MandelbrotSet::chosen_scalar(algorithm_type algorithm) {
+    if(algorithm != OPTIMIZED && algorithm != PERIODIC && algorithm != HISTOGRAM && algorithm != VECTORIZED) return SCALAR_DOUBLE;
+#ifndef MANDELBROT_FIXED128
+    if(scalar == SCALAR_FIXED128) return SCALAR_DOUBLE_DOUBLE;
+#endif
+    if(scalar != SCALAR_AUTO) return scalar;
+
+    double spacing = min(span_x / width, span_y / height);
+    double magnitude = max(max(abs(lim_l), abs(lim_r)), max(abs(lim_t), abs(lim_b)));
+    scalar_type types[5] = { SCALAR_FLOAT, SCALAR_DOUBLE, SCALAR_LONG_DOUBLE, SCALAR_FIXED128, SCALAR_DOUBLE_DOUBLE };
+    for(int k = 0; k < 5; k ++) {
+        double resolution = scalar_resolution(types[k], magnitude);
+        if(resolution > 0 && resolution * SCALAR_MARGIN <= spacing) return types[k];
+    }
+    // No type is precise enough, so the most precise one is used
+#ifdef MANDELBROT_FIXED128
+    return SCALAR_FIXED128;
+#else
+    return SCALAR_DOUBLE_DOUBLE;
+#endif
+}
+
+const char* algorithm_name(algorithm_type algorithm) {
+    static const char* names[] = {"auto", "unoptimized", "optimized", "periodic", "continuous", "histogram", "vectorized",
+                                  "subdivision", "perturbation", "distance"};
+    return names[algorithm];
+}
+
+// Calling the chosen algorithm
+// With a time budget, the scheduler decides how the algorithm chosen by AUTO is rendered (perturbation is the only
+// algorithm which can render deep zooms, so it is always rendered directly)
+void MandelbrotSet::Algorithm(bool addToStack) {
+    algorithm_type chosen = chosen_algorithm();
+    if(algorithm == AUTO && time_budget > 0 && chosen != PERTURBATION) this -> scheduled_algorithm(chosen, addToStack);
+    else this -> run_algorithm(chosen, addToStack);
+}
+
+void MandelbrotSet::run_algorithm(algorithm_type chosen, bool addToStack) {
+    if(chosen == UNOPTIMIZED) this -> unoptimizedEscapeTime(addToStack);
+    else if(chosen == OPTIMIZED) this -> optimizedEscapeTime(addToStack);
+    else if(chosen == PERIODIC) this -> periodicallyCheckedEscapeTime(addToStack);
+    else if(chosen == CONTINUOUS) this -> continuousColoring(addToStack);
+    else if(chosen == HISTOGRAM) this -> histogramColoring(addToStack);
+    else if(chosen == SUBDIVISION) this -> subdivisionEscapeTime(addToStack);
+    else if(chosen == PERTURBATION) this -> perturbationEscapeTime(addToStack);
+    else if(chosen == DISTANCE) this -> distanceEstimation(addToStack);
+    else this -> vectorizedEscapeTime(addToStack);
 }
 
 // Finding power (x^n) for large values of n
@@ -136,325 +604,1825 @@ double power(double x, long long n) {
 
 // Zooming in, taking (x,y) as the zoom origin
 void MandelbrotSet::zoom_in(double x, double y) {
-    // Max value of zoom is 62 (since we have to do 2^zoom, and we do not wish to overflow)
-    if(zoom == 62) return;
+    // Offsets of points from the center are doubles, so zooming stops before their spacing gets too small for doubles
+    if(min(span_x / width, span_y / height) < MIN_SPACING) return;
+    this -> save_previous();
 
-    // x0 consists the position of the point x on the number line from lim_l to lim_r
-    double x0 = lim_l + ((lim_r - lim_l) * x) / width;
-    // y0 consists the position of the point y on the number line from lim_b to lim_t
-    double y0 = lim_b + ((lim_t - lim_b) * y) / height;
+    // Offsets of the point (x,y) from the center of the view
+    // (x lies on the number line from lim_l to lim_r, and y on the number line from lim_b to lim_t)
+    double dx = span_x * (x / width - 0.5);
+    double dy = span_y * (y / height - 0.5);
 
     // zoom factor increased by 1
     zoom ++;
-    // two_zoom = 2 ^ zoom, used to find change in limits
-    long long two_zoom = power(2, zoom);
-    // multiplier is the factor by which the limits are changed
-    // multiplier is taken as 0.9 - (1/2)^(two_zoom), where 0.9 was found as an optimal value based on different trials
-    double multiplier = 0.9 - power(0.5, two_zoom);
-
-    lim_l *= multiplier;
-    lim_r *= multiplier;
-    lim_t *= multiplier;
-    lim_b *= multiplier;
-
-    // Centering the limits at (x0, y0) by shifting the origin to this point
-    // Horizontal shift is distance between mid point of lim_l, lim_r and x0
-    double horizontal_shift = x0 - (lim_l + lim_r) / 2;
-    // Vertical shift is distance between mid point of lim_b, lim_t and y0
-    double vertical_shift = y0 - (lim_t + lim_b) / 2;
-
-    // Shifting horizontal limits by horizontal_shift
-    lim_l += horizontal_shift;
-    lim_r += horizontal_shift;
-    // Shifting vertical limits by vertical_shift
-    lim_t += vertical_shift;
-    lim_b += vertical_shift;
+    // multiplier is the factor by which the size of the view is changed
+    // multiplier is taken as 0.9 - (1/2)^(2^zoom), where 0.9 was found as an optimal value based on different trials
+    // (2^zoom is found only while it fits in a long long, beyond that (1/2)^(2^zoom) is 0 anyway)
+    double multiplier = 0.9;
+    if(zoom <= 62) {
+        long long two_zoom = power(2, zoom);
+        multiplier -= power(0.5, two_zoom);
+    }
+    span_x *= multiplier;
+    span_y *= multiplier;
+
+    // The view is centered at (x,y), with enough precision to tell apart adjacent points of the new view
+    int limbs = limbs_for_spacing(min(span_x / width, span_y / height));
+    center_x.set_precision(limbs);
+    center_y.set_precision(limbs);
+    center_x = center_x + big_number(dx, limbs);
+    center_y = center_y + big_number(dy, limbs);
+    this -> update_limits();
 }
 
-// Zooming out, by taking the previous element on the stack of plots
-void MandelbrotSet::zoom_out() {
-    if(zoom != 1) {
-        // Remove the topmost (current element) and take the previous element on the stack
-        pixels_data data = st.pop();
-        // points, zoom and limits changed to that of current top element of stack
-        points = data.points;
-        zoom = data.zoom;
-        lim_l = data.lim_l;
-        lim_r = data.lim_r;
-        lim_t = data.lim_t;
-        lim_b = data.lim_b;
-    }
+// Moving the view by a whole number of points, so that the points which stay in the window are the same points as before
+// (and only the strip of new points has to be iterated, when reprojection is enabled)
+void MandelbrotSet::pan(int dx, int dy) {
+    this -> save_previous();
+    // The view replaces the rendering at this zoom in the stack (pushed by the next rendering)
+    if(st.size() > 0) st.pop();
+    int limbs = center_x.precision();
+    center_x = center_x + big_number(span_x * dx / width, limbs);
+    center_y = center_y + big_number(span_y * dy / height, limbs);
+    this -> update_limits();
 }
 
-void MandelbrotSet::unoptimizedEscapeTime(bool addToStack) {
+// Limits are found from the center of the view (they are only used in doubles, so they lose precision in deep zooms)
+void MandelbrotSet::update_limits() {
+    double x = center_x.to_double();
+    double y = center_y.to_double();
+    lim_l = x - span_x / 2;
+    lim_r = x + span_x / 2;
+    lim_b = y - span_y / 2;
+    lim_t = y + span_y / 2;
+}
 
-    for(int i = 0; i < width; i ++) {
-        for(int  j = 0; j < height; j ++) {
-            // Find point (x0,y0) in the limits corresponding to (i,j)
-            // Complex number c = x0 + iy0
-            double x0 = lim_l + ((lim_r - lim_l) * i) / width;
-            double y0 = lim_b + ((lim_t - lim_b) * j) / height;
-            // Complex number z = x + iy
-            double x = 0;
-            double y = 0;
-
-            // Number of iterations required for z to get outside circle centered at origin of radius 2
-            int iteration = 0;
-            while(x * x + y * y <= 4 && iteration < max_iteration) {
-                // New values of x and y found as x = Re(z^2 + c) and y = Im(z^2 + c)
-                double xtemp = x * x - y * y + x0;
-                y = 2 * x * y + y0;
-                x = xtemp;
-                iteration ++;
-            }
+// Zooming out, by taking the previous element on the stack of plots
+void MandelbrotSet::zoom_out() {
+    if(zoom != 1 && st.size() > 1) {
+        // The zoomed in rendering is kept with its own view (if the plot has to be rendered again, it reuses its points)
+        this -> save_previous();
+        // Remove (and free) the topmost (current element) and take the previous element on the stack
+        st.pop();
+        const pixels_data* data = st.peek();
+        // zoom and limits changed to that of current top element of stack
+        zoom = data -> zoom;
+        lim_l = data -> lim_l;
+        lim_r = data -> lim_r;
+        lim_t = data -> lim_t;
+        lim_b = data -> lim_b;
+        center_x = data -> center_x;
+        center_y = data -> center_y;
+        span_x = data -> span_x;
+        span_y = data -> span_y;
 
-            // Point at (i,j) colored with iteration (mod p) element of the color palette
-            points[i*width + j].position = sf::Vector2f(i, j);
-            points[i*width + j].color = palette[iteration % p];
+        // Colors of points are decompressed directly into the framebuffer from the saved rendering
+        // Iteration buffers and orbits still belong to the zoomed in plot, so they cannot be used
+        if(data -> restore(framebuffer)) {
+            have_iterations = false;
+            have_orbits = false;
+            dirty = true;
         }
+        // If its colors were evicted from the stack, then the plot is rendered again (it is already on the stack)
+        else this -> Algorithm(false);
     }
+}
+
+// Splitting the window into square tiles of side TILE_SIZE, and rendering them on the threads of the pool
+// Tiles inside the Set take much longer than tiles outside it, so the threads steal tiles from each other
+// (instead of every thread getting a fixed part of the window)
+void MandelbrotSet::render_tiles(const function<void(int, int, int, int)>& render_tile) {
+    int tiles_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+    int tiles_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+    pool.parallel_for(tiles_x * tiles_y, [&](int tile) {
+        // Remaining tiles of a cancelled rendering are skipped
+        if(cancel_requested) return;
+        // Tile covers the points (i,j) with i in [i_start, i_end) and j in [j_start, j_end)
+        int i_start = (tile % tiles_x) * TILE_SIZE;
+        int j_start = (tile / tiles_x) * TILE_SIZE;
+        int i_end = min(i_start + TILE_SIZE, width);
+        int j_end = min(j_start + TILE_SIZE, height);
+        TELEMETRY_TILE_BEGIN();
+        render_tile(i_start, i_end, j_start, j_end);
+        TELEMETRY_TILE_END(tile);
+        work_done += (long long)(i_end - i_start) * (j_end - j_start);
+    });
+}
 
-    // Add the plot created to the stack if addToStack variable is true
+// Add the current plot to the stack if addToStack variable is true
+void MandelbrotSet::save_rendering(bool addToStack) {
+    // The rendering is finished once it is saved
+    TELEMETRY_LAST_PHASE(PHASE_STACK_PUSH);
+    // Tiles of a rendering which was not cancelled are cached
+    if(caching && !cancel_requested) this -> store_in_cache();
+    caching = false;
     if(addToStack) {
-        pixels_data* new_elem = new pixels_data;
-        new_elem -> points = points;
+        unique_ptr<pixels_data> new_elem(new pixels_data);
+        // Colors of a cancelled rendering are unfinished, so only its view is saved
+        if(!cancel_requested) new_elem -> store(framebuffer);
         new_elem -> lim_l = lim_l;
         new_elem -> lim_r = lim_r;
         new_elem -> lim_t = lim_t;
         new_elem -> lim_b = lim_b;
         new_elem -> zoom = zoom;
-        st.push(new_elem);
+        new_elem -> center_x = center_x;
+        new_elem -> center_y = center_y;
+        new_elem -> span_x = span_x;
+        new_elem -> span_y = span_y;
+        st.push(move(new_elem));
     }
 }
 
-void MandelbrotSet::optimizedEscapeTime(bool addToStack) {
+// Given c1 and c2 on the number line, find point dividing the line segment between them in (1-t):t ratio
+double linear_interpolation(double c1, double c2, double t) {
+    return (1-t)*c1 + t*c2;
+}
 
-    for(int i = 0; i < width; i ++) {
-        for(int  j = 0; j < height; j ++) {
-            // Find point (x0,y0) in the limits corresponding to (i,j)
-            // Complex number c = x0 + iy0
-            double x0 = lim_l + ((lim_r - lim_l) * i) / width;
-            double y0 = lim_b + ((lim_t - lim_b) * j) / height;
-            // Complex number z = x + iy
-            double x = 0;
-            double y = 0;
-            // To reduce computations, maintaining variables x2 = x^2 and y2 = y^2
-            double x2 = 0;
-            double y2 = 0;
-
-            // Number of iterations required for z to get outside circle centered at origin of radius 2
-            int iteration = 0;
-            while(x2 + y2 <= 4 && iteration < max_iteration) {
-                // New values of x and y found as x = Re(z^2 + c) and y = Im(z^2 + c)
-                // Uses only 3 multiplications inside while loop, unlike 5 for the unoptimized version
-                y = (x + x) * y + y0;
-                x = x2 - y2 + x0;
-                x2 = x * x;
-                y2 = y * y;
-                iteration ++;
+// Finding PALETTE_STEPS colors from every color of the palette to the next one (the last color, p - 1, goes to the
+// first one, as colors are taken mod p), by linear interpolation of the red, green and blue values
+void MandelbrotSet::interpolate_palette() {
+    smooth_palette.resize(p * PALETTE_STEPS);
+    for(int k = 0; k < p; k ++) {
+        sf::Color c1 = palette[k];
+        sf::Color c2 = palette[(k + 1) % p];
+        for(int step = 0; step < PALETTE_STEPS; step ++) {
+            double t = (double)step / PALETTE_STEPS;
+            smooth_palette[k * PALETTE_STEPS + step] = sf::Color((sf::Uint8)linear_interpolation(c1.r, c2.r, t),
+                                                                 (sf::Uint8)linear_interpolation(c1.g, c2.g, t),
+                                                                 (sf::Uint8)linear_interpolation(c1.b, c2.b, t));
+        }
+    }
+}
+
+// Coloring all points using the iteration buffers filled by the last rendering and the current palette
+// Orbits are not iterated again, so this is a single pass over the buffers (three for histogram coloring)
+void MandelbrotSet::recolor() {
+    if(cancel_requested) {
+        have_iterations = false;
+        have_orbits = false;
+        return;
+    }
+    // For histogram coloring, cumulative[k] is the number of points having iteration count at most k
+    vector<int> cumulative;
+    if(coloring == HISTOGRAM_COLORING && !shared_histogram.empty()) {
+        // Prefix sums of the shared histogram, taken mod p (the counts of a large image can exceed an int, and only
+        // their remainders are used for the colors)
+        cumulative.assign(max_iteration + 1, 0);
+        long long total = 0;
+        for(int k = 0; k <= max_iteration; k ++) {
+            if(k < (int)shared_histogram.size()) total += shared_histogram[k];
+            cumulative[k] = (int)(total % p);
+        }
+    }
+    else if(coloring == HISTOGRAM_COLORING) {
+        TELEMETRY_PHASE(PHASE_HISTOGRAM);
+        // Every thread counts the iteration counts of its tiles in its own histogram (so no locking is needed)
+        int threads = pool.get_threads();
+        int bins = max_iteration + 1;
+        vector<int> histograms(threads * bins, 0);
+        render_tiles([&](int i_start, int i_end, int j_start, int j_end) {
+            int* histogram = &histograms[pool.thread_index() * bins];
+            for(int j = j_start; j < j_end; j ++) {
+                for(int i = i_start; i < i_end; i ++) {
+                    histogram[iterations[j*width + i]] ++;
+                }
             }
+        });
 
-            // Point at (i,j) colored with iteration (mod p) element of the color palette
-            points[i*width + j].position = sf::Vector2f(i, j);
-            points[i*width + j].color = palette[iteration % p];
+        // Merging the histograms, and taking prefix sums of the counts
+        cumulative.assign(bins, 0);
+        int total = 0;
+        for(int k = 0; k < bins; k ++) {
+            for(int t = 0; t < threads; t ++) {
+                total += histograms[t * bins + k];
+            }
+            cumulative[k] = total;
         }
     }
 
-    // Add the plot created to the stack if addToStack variable is true
-    if(addToStack) {
-        pixels_data* new_elem = new pixels_data;
-        new_elem -> points = points;
-        new_elem -> lim_l = lim_l;
-        new_elem -> lim_r = lim_r;
-        new_elem -> lim_t = lim_t;
-        new_elem -> lim_b = lim_b;
-        new_elem -> zoom = zoom;
-        st.push(new_elem);
+    TELEMETRY_PHASE(PHASE_COLORING);
+    render_tiles([&](int i_start, int i_end, int j_start, int j_end) {
+        for(int j = j_start; j < j_end; j ++) {
+            for(int i = i_start; i < i_end; i ++) {
+                int iteration = iterations[j*width + i];
+                int iter;
+
+                if(coloring == HISTOGRAM_COLORING) {
+                    // Number of points which have iteration count at most the iteration count for (i,j)
+                    iter = cumulative[iteration];
+                }
+                else if(coloring == CONTINUOUS_COLORING) {
+                    // Points inside the Set take the first color, others take the color of the interpolated palette
+                    // between the colors of their integer part and the next integer, at their fractional part (rounded down)
+                    // (a float just below 1 can round up to 1, so the step is at most PALETTE_STEPS - 1)
+                    if(iteration >= max_iteration) framebuffer[j*width + i] = palette[0];
+                    else {
+                        int step = min((int)(fractions[j*width + i] * PALETTE_STEPS), PALETTE_STEPS - 1);
+                        framebuffer[j*width + i] = smooth_palette[(iteration % p) * PALETTE_STEPS + step];
+                    }
+                    continue;
+                }
+                else if(coloring == DISTANCE_COLORING) {
+                    // Points of the Set (distance 0) take the first color, and points outside it are shaded from the first
+                    // color to white, which they reach DISTANCE_SHADE points away from the Set
+                    double t = min(1.0, distances[j*width + i] / DISTANCE_SHADE);
+                    sf::Color c = palette[0];
+                    framebuffer[j*width + i] = sf::Color((sf::Uint8)linear_interpolation(c.r, 255, t),
+                                                         (sf::Uint8)linear_interpolation(c.g, 255, t),
+                                                         (sf::Uint8)linear_interpolation(c.b, 255, t));
+                    continue;
+                }
+                else {
+                    iter = iteration;
+                }
+
+                // Point at (i,j) colored with iter (mod p) element of the color palette
+                // (it is in row j and column i of the framebuffer)
+                framebuffer[j*width + i] = palette[iter % p];
+            }
+        }
+    });
+
+    // If the rendering was cancelled, then the buffers are unfinished, so they cannot be used again
+    if(cancel_requested) {
+        have_iterations = false;
+        have_orbits = false;
+        return;
     }
+    have_iterations = true;
+    dirty = true;
 }
 
-void MandelbrotSet::periodicallyCheckedEscapeTime(bool addToStack) {
+// Checking whether c = x0 + iy0 lies in the main cardioid or in the period-2 bulb (circle of radius 1/4 around -1)
+// All such points are in the Set, so their orbits never escape and do not have to be iterated
+// Returns the period of the attracting cycle of such points (1 in the cardioid, 2 in the bulb), and 0 for other points
+static inline int in_cardioid_or_bulb(double x0, double y0) {
+    // Main cardioid: q (q + (x0 - 1/4)) <= y0^2 / 4, where q = (x0 - 1/4)^2 + y0^2
+    double y2 = y0 * y0;
+    double xq = x0 - 0.25;
+    double q = xq * xq + y2;
+    if(q * (q + xq) <= 0.25 * y2) return 1;
+    // Period-2 bulb: (x0 + 1)^2 + y0^2 <= 1/16
+    double xb = x0 + 1;
+    if(xb * xb + y2 <= 0.0625) return 2;
+    return 0;
+}
+
+// Brent's cycle detection, checked after every iteration of an orbit (z = x + iy after iteration iterations)
+// Value of z is saved at every power of 2, so an orbit ending in a cycle of period k is caught within about 2 max(k, m)
+// iterations of entering it at iteration m, without keeping any history
+// Returns true (and sets period) if z came back within tolerance of the saved value
+static inline bool cycle_found(orbit_state& z, double x, double y, int iteration, double tolerance, int& period) {
+    if(abs(x - z.xold) < tolerance && abs(y - z.yold) < tolerance) {
+        period = iteration - z.saved_at;
+        return true;
+    }
+    if((iteration & (iteration - 1)) == 0) {
+        z.xold = x;
+        z.yold = y;
+        z.saved_at = iteration;
+    }
+    return false;
+}
+
+// Functions to iterate the orbit of c = x0 + iy0, starting from z (which has already been iterated iteration times)
+// Each of them returns the number of iterations required for z to get outside the escape circle (or max_iteration),
+// and leaves the last value of z in z.x and z.y, so that the orbit can be continued later
+// If tolerance > 0, then cycles are also detected, in which case period is set and max_iteration is returned
+
+// Escape time iteration, unoptimized version (5 multiplications per iteration)
+static inline int unoptimized_orbit(double x0, double y0, orbit_state& z, int iteration, int max_iteration, double tolerance, int& period) {
+    double x = z.x;
+    double y = z.y;
+    while(x * x + y * y <= 4 && iteration < max_iteration) {
+        // New values of x and y found as x = Re(z^2 + c) and y = Im(z^2 + c)
+        double xtemp = x * x - y * y + x0;
+        y = 2 * x * y + y0;
+        x = xtemp;
+        iteration ++;
+        if(tolerance > 0 && cycle_found(z, x, y, iteration, tolerance, period)) {
+            iteration = max_iteration;
+            break;
+        }
+    }
+    z.x = x;
+    z.y = y;
+    return iteration;
+}
+
+// Escape time iteration, optimized version, in any scalar type T (float, double, long double, double_double, fixed128)
+// z and its value saved for cycle detection are kept in T, and are rounded to doubles only when they are saved in the
+// orbit state (which is exact for floats and doubles, so only their orbits can be continued)
+template<typename T>
+static inline int optimized_orbit(T x0, T y0, orbit_state& z, int iteration, int max_iteration, double tolerance, int& period) {
+    T x = T(z.x);
+    T y = T(z.y);
+    T xold = T(z.xold);
+    T yold = T(z.yold);
+    // To reduce computations, maintaining variables x2 = x^2 and y2 = y^2
+    T x2 = x * x;
+    T y2 = y * y;
+    const T four = T(4.0);
+    while(x2 + y2 <= four && iteration < max_iteration) {
+        // New values of x and y found as x = Re(z^2 + c) and y = Im(z^2 + c)
+        // Uses only 3 multiplications inside while loop, unlike 5 for the unoptimized version
+        y = (x + x) * y + y0;
+        x = x2 - y2 + x0;
+        x2 = x * x;
+        y2 = y * y;
+        iteration ++;
+        // Brent's cycle detection, as in cycle_found
+        if(tolerance > 0) {
+            if(fabs(to_double(x - xold)) < tolerance && fabs(to_double(y - yold)) < tolerance) {
+                period = iteration - z.saved_at;
+                iteration = max_iteration;
+                break;
+            }
+            if((iteration & (iteration - 1)) == 0) {
+                xold = x;
+                yold = y;
+                z.saved_at = iteration;
+            }
+        }
+    }
+    z.x = to_double(x);
+    z.y = to_double(y);
+    z.xold = to_double(xold);
+    z.yold = to_double(yold);
+    return iteration;
+}
+
+// Finding the coordinate in scalar type T of point k out of n along an axis of the view (with limits lim_low and
+// lim_high, width span and center in T)
+// More precise types add the offset of the point to the center, since the limits are only doubles
+template<typename T>
+static inline T point_coordinate(const T& center, double /* lim_low */, double /* lim_high */, double span, int k, int n) {
+    return center + T(span * ((double)k / n - 0.5));
+}
+
+// Floats and doubles use the limits, in the same way as all other algorithms
+template<>
+inline double point_coordinate<double>(const double& /* center */, double lim_low, double lim_high, double /* span */, int k,
+                                        int n) {
+    return lim_low + ((lim_high - lim_low) * k) / n;
+}
+
+template<>
+inline float point_coordinate<float>(const float& /* center */, double lim_low, double lim_high, double /* span */, int k,
+                                      int n) {
+    return (float)(lim_low + ((lim_high - lim_low) * k) / n);
+}
+
+// Converting a big number to scalar type T, as the sum of three doubles (about 159 bits, enough for every type)
+template<typename T>
+static T from_big_number(const big_number& value) {
+    int limbs = value.precision();
+    double hi = value.to_double();
+    big_number rest = value - big_number(hi, limbs);
+    double mid = rest.to_double();
+    double lo = (rest - big_number(mid, limbs)).to_double();
+    return T(hi) + T(mid) + T(lo);
+}
+
+// Escape time iteration used by continuous coloring (escape radius 2^8 instead of 2), optimized version
+// (3 multiplications per iteration, same values of z as computing x^2 and y^2 twice)
+static inline int continuous_orbit(double x0, double y0, orbit_state& z, int iteration, int max_iteration, double tolerance, int& period) {
+    double x = z.x;
+    double y = z.y;
+    double x2 = x * x;
+    double y2 = y * y;
+    while(x2 + y2 <= SMOOTH_BAILOUT && iteration < max_iteration) {
+        y = (x + x) * y + y0;
+        x = x2 - y2 + x0;
+        x2 = x * x;
+        y2 = y * y;
+        iteration ++;
+        if(tolerance > 0 && cycle_found(z, x, y, iteration, tolerance, period)) {
+            iteration = max_iteration;
+            break;
+        }
+    }
+    z.x = x;
+    z.y = y;
+    return iteration;
+}
+
+// Constants of fast_log2: sqrt(2), and the coefficients 2 / (k ln 2) of the series of log2
+static const double SQRT_2 = 1.4142135623730951;
+static const double LOG2_C1 = 2.8853900817779268;
+static const double LOG2_C3 = 0.96179669392597560;
+static const double LOG2_C5 = 0.57707801635558536;
+
+// Base 2 logarithm of a positive (finite, normal) double, within 2e-6 of log2(x), without calling log
+// x = m 2^e is split by reading its bits, m is moved to [sqrt(1/2), sqrt(2)), and log2(m) = 2 atanh(t) / ln 2 with
+// t = (m - 1) / (m + 1), which is within 0.172 of 0, so the first three terms of the series of atanh are enough
+// It has no calls and no branches, and uses only operations which SSE2 has for vectors (the exponent is turned into a
+// double by placing it in the mantissa of 2^52, and m is halved by a multiplication by 0 or 1), so loops over it are
+// vectorized by the compiler
+static inline double fast_log2(double x) {
+    unsigned long long bits;
+    memcpy(&bits, &x, sizeof(bits));
+    unsigned long long exponent_bits = (bits >> 52) | 0x4330000000000000ULL;
+    double e;
+    memcpy(&e, &exponent_bits, sizeof(e));
+    e -= 4503599627370496.0 + 1023;
+    bits = (bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+    double m;
+    memcpy(&m, &bits, sizeof(m));
+    double high = m > SQRT_2 ? 1.0 : 0.0;
+    m -= m * 0.5 * high;
+    e += high;
+    double t = (m - 1) / (m + 1);
+    double t2 = t * t;
+    return e + t * (LOG2_C1 + t2 * (LOG2_C3 + t2 * LOG2_C5));
+}
+
+// Finding the (fractional) iteration count of a point which escaped after iteration steps, with |z|^2 = radius
+// (at least SMOOTH_BAILOUT): iteration + 1 - log2(log2 |z|), within 1e-5 of the exact value
+static inline double smooth_iteration(double radius, int iteration) {
+    // log2 |z| = log2(|z|^2) / 2
+    double mu = fast_log2(0.5 * fast_log2(radius));
+    // New iterations are no longer an integer
+    return (double)iteration + 1 - mu;
+}
+
+// Escape time iteration used by distance estimation, which also iterates the derivative of z with respect to c,
+// dz' = 2 z dz + 1 (dz = dx + i dy, starting at 0), with the escape radius of continuous coloring (the distance
+// estimate is accurate only for large |z|)
+static inline int distance_orbit(double x0, double y0, orbit_state& z, double& dx, double& dy, int iteration, int max_iteration, double tolerance, int& period) {
+    double x = z.x;
+    double y = z.y;
+    double x2 = x * x;
+    double y2 = y * y;
+    while(x2 + y2 <= SMOOTH_BAILOUT && iteration < max_iteration) {
+        // Derivative is found from z before it is updated
+        double dxtemp = 2 * (x * dx - y * dy) + 1;
+        dy = 2 * (x * dy + y * dx);
+        dx = dxtemp;
+        y = (x + x) * y + y0;
+        x = x2 - y2 + x0;
+        x2 = x * x;
+        y2 = y * y;
+        iteration ++;
+        if(tolerance > 0 && cycle_found(z, x, y, iteration, tolerance, period)) {
+            iteration = max_iteration;
+            break;
+        }
+    }
+    z.x = x;
+    z.y = y;
+    return iteration;
+}
+
+// Finding the distance from the Set of a point which escaped after iteration steps, with z = x + iy and dz = dx + i dy,
+// in units of spacing: the estimate |z| ln|z| / (2 |dz|), and the lower bound sinh(G) / (2 e^G |G'|) of the true distance
+// (from the Koebe quarter theorem), where G = ln|z| / 2^iteration is the Green function of the point
+// The lower bound is the estimate times (1 - e^-2G) / 2G, which is close to 1 near the Set, and the true distance is at
+// most 4 times the estimate
+static inline void exterior_distance(double x, double y, double dx, double dy, int iteration, double spacing, double& estimate, double& lower) {
+    double r = sqrt(x * x + y * y);
+    double log_r = log(r);
+    estimate = r * log_r / (2 * sqrt(dx * dx + dy * dy)) / spacing;
+    double g = ldexp(log_r, -iteration);
+    lower = g > 0 ? estimate * -expm1(-2 * g) / (2 * g) : estimate;
+}
+
+// Starting a new rendering with the given algorithm, which will save the orbits of points that do not escape
+// and count the points skipped by the interior check
+void MandelbrotSet::start_rendering(algorithm_type algorithm) {
+    TELEMETRY_START(width * height, (width + TILE_SIZE - 1) / TILE_SIZE, (height + TILE_SIZE - 1) / TILE_SIZE);
+    // Rendering the same view again (e.g. at another precision) reuses the plot in the framebuffer
+    this -> save_previous();
+    interior_skipped = 0;
+    filled = 0;
+    rebases = 0;
+    series_skipped = 0;
+    work_done = 0;
+    work_total = (long long)width * height;
+    orbits.clear();
+    orbits_algorithm = algorithm;
+    rendered_max_iteration = max_iteration;
+    have_orbits = true;
+    last_scalar = SCALAR_DOUBLE;
+    tolerance = cycle_tolerance(algorithm);
+    TELEMETRY_PHASE(PHASE_SETUP);
+    this -> reproject(algorithm);
+    this -> fill_from_cache(algorithm);
+}
+
+// Keeping the current rendering before the view is changed, if its iteration buffers belong to the plot in the framebuffer
+// Buffers are moved out of the Set (the next rendering fills them again), so they no longer belong to the plot
+void MandelbrotSet::save_previous() {
+    if(!reprojection || !have_iterations) return;
+    previous.center_x = center_x;
+    previous.center_y = center_y;
+    previous.span_x = span_x;
+    previous.span_y = span_y;
+    previous.max_iteration = rendered_max_iteration;
+    previous.algorithm = orbits_algorithm;
+    previous.scalar = last_scalar;
+    previous.iterations.swap(iterations);
+    previous.fractions.swap(fractions);
+    previous.orbits.swap(orbits);
+    previous.have_orbits = have_orbits;
+    previous.periods = periods;
+    previous.colors = framebuffer;
+    iterations.resize(width * height);
+    fractions.resize(width * height);
+    orbits.clear();
+    have_iterations = false;
+    have_orbits = false;
+    have_previous = true;
+}
+
+// Reprojecting the previous rendering onto the view of a new rendering (at its start)
+// Point (i,j) of the new view lies at column u and row v of the previous view (not whole numbers in general), so it is
+// shown with the color of the nearest point of the previous view, and it reuses its iteration count if it is within the
+// tolerance of it along both axes
+// Iteration counts are reused only from a rendering with the same precision, algorithm and scalar type, by the algorithms
+// which check is_reused before iterating a point
+void MandelbrotSet::reproject(algorithm_type algorithm) {
+    reusing = false;
+    reprojected = false;
+    reused_points = 0;
+    if(!reprojection || !have_previous) return;
+
+    bool reuse = previous.max_iteration == max_iteration && previous.algorithm == algorithm
+        && previous.scalar == chosen_scalar(algorithm) && algorithm != UNOPTIMIZED && algorithm != SUBDIVISION
+        && algorithm != DISTANCE;
+    // Offset of the new center from the previous one
+    double dcx = (center_x - previous.center_x).to_double();
+    double dcy = (center_y - previous.center_y).to_double();
+
+    // Nearest column of the previous view to every column of the new view, and whether it is within the tolerance
+    // (columns outside the previous view take the nearest edge for the preview)
+    vector<int> column(width);
+    vector<char> column_match(width);
     for(int i = 0; i < width; i ++) {
-        for(int  j = 0; j < height; j ++) {
-            // Find point (x0,y0) in the limits corresponding to (i,j)
-            // Complex number c = x0 + iy0
-            double x0 = lim_l + ((lim_r - lim_l) * i) / width;
-            double y0 = lim_b + ((lim_t - lim_b) * j) / height;
-            // Complex number z = x + iy
-            double x = 0;
-            double y = 0;
-            // To reduce computations, maintaining variables x2 = x^2 and y2 = y^2
-            double x2 = 0;
-            double y2 = 0;
-            // To further reduce computations maintaining variables xold = x and yold = y after some period of iterations
-            double xold = 0;
-            double yold = 0;
-            // Period after which xold and yold are changed to current x and y values
-            int period = 0;
-            // Number of iterations required for z to get outside circle centered at origin of radius 2
-            int iteration = 0;
-
-            while(x2 + y2 <= 4 && iteration < max_iteration) {
-                // New values of x and y found as x = Re(z^2 + c) and y = Im(z^2 + c)
-                y = (x + x) * y + y0;
-                x = x2 - y2 + x0;
-                x2 = x * x;
-                y2 = y * y;
-                iteration ++;
-
-                // Checking whether difference between x and y with xold and yold is small
-                bool small_x = abs(x - xold) < 1e-4;
-                bool small_y = abs(y - yold) < 1e-4;
-
-                // If x and y haven't changed much, then not expected to change much in future also
-                // Then (i,j) is part of the Set, and so we will need to run it for max number of iterations
-                if(small_x && small_y) {
-                    iteration = max_iteration;
-                    break;
+        double u = ((dcx + span_x * ((double)i / width - 0.5)) / previous.span_x + 0.5) * width;
+        int k = (int)floor(u + 0.5);
+        column_match[i] = k >= 0 && k < width && fabs(u - k) * previous.span_x <= reprojection_tolerance * span_x;
+        column[i] = min(max(k, 0), width - 1);
+    }
+    // Same for the rows
+    vector<int> row(height);
+    vector<char> row_match(height);
+    for(int j = 0; j < height; j ++) {
+        double v = ((dcy + span_y * ((double)j / height - 0.5)) / previous.span_y + 0.5) * height;
+        int k = (int)floor(v + 0.5);
+        row_match[j] = k >= 0 && k < height && fabs(v - k) * previous.span_y <= reprojection_tolerance * span_y;
+        row[j] = min(max(k, 0), height - 1);
+    }
+
+    // Index of the saved orbit of every point of the previous rendering (-1 if it has none)
+    vector<int> orbit_index;
+    if(reuse && previous.have_orbits) {
+        orbit_index.assign(width * height, -1);
+        for(size_t k = 0; k < previous.orbits.size(); k ++) {
+            orbit_index[previous.orbits[k].j * width + previous.orbits[k].i] = k;
+        }
+    }
+    bool reuse_periods = period_output && previous.periods.size() == periods.size();
+    reuse_source.assign(width * height, -1);
+
+    for(int j = 0; j < height; j ++) {
+        for(int i = 0; i < width; i ++) {
+            int source = row[j] * width + column[i];
+            framebuffer[j*width + i] = previous.colors[source];
+            if(!reuse || !column_match[i] || !row_match[j]) continue;
+
+            // Same iteration count (and fractional part and period) as the point of the previous rendering
+            reuse_source[j*width + i] = source;
+            iterations[j*width + i] = previous.iterations[source];
+            fractions[j*width + i] = previous.fractions[source];
+            if(period_output) periods[j*width + i] = reuse_periods ? previous.periods[source] : 0;
+            reused_points ++;
+            // Its orbit (if it did not escape) is saved again for point (i,j), so it can still be continued
+            if(!orbit_index.empty() && orbit_index[source] >= 0) {
+                orbit_state z = previous.orbits[orbit_index[source]];
+                z.i = i;
+                z.j = j;
+                orbits.push_back(z);
+            }
+        }
+    }
+    reusing = reuse && reused_points > 0;
+
+    // The reprojected rendering is shown as a preview till the new one is finished (previews never come from a
+    // stopped rendering)
+    reprojected = true;
+    dirty = true;
+    if(preview_listener && !cancel_requested) preview_listener();
+}
+
+// Placing the n points along an axis of the view (with a center and a span) on the grid of the tile cache, with cells of
+// 2^exponent: position of every point in its tile (in cells), first point of every tile (followed by n), and hash of the
+// origin of every tile
+// Positions are found from the center in high precision (with only the offsets of the points in doubles, as in the
+// perturbation algorithm), so points keep the same position in the grid in deep zooms and after panning
+static void cache_axis(const big_number& center, double span, int n, int exponent, vector<double>& position,
+                       vector<int>& starts, vector<unsigned long long>& origins) {
+    // Origin of the tile holding the center, and position of the center from it (in cells)
+    big_number origin = center.round_down(exponent + CACHE_TILE_BITS);
+    double center_cells = ldexp((center - origin).to_double(), -exponent);
+
+    position.resize(n);
+    starts.clear();
+    origins.clear();
+    double last_tile = 0;
+    for(int k = 0; k < n; k ++) {
+        double u = center_cells + ldexp(span * ((double)k / n - 0.5), -exponent);
+        double tile = floor(u / CACHE_TILE);
+        // Position is exact, since u and the origin of its tile are close multiples of the precision of u
+        position[k] = u - tile * CACHE_TILE;
+        if(k == 0 || tile != last_tile) {
+            starts.push_back(k);
+            // Origin of the tile in high precision (the offset from the tile of the center is an exact double)
+            double offset = ldexp(tile, exponent + CACHE_TILE_BITS);
+            origins.push_back((origin + big_number(offset, origin.precision())).hash());
+        }
+        last_tile = tile;
+    }
+    starts.push_back(n);
+}
+
+// Placing the points of the view on the grid of the tile cache
+// Cells are the largest powers of 2 not larger than the spacing of the points, and tiles are CACHE_TILE cells, with
+// their corners at multiples of their size, so the grid only depends on the zoom and not on the view
+void MandelbrotSet::cache_grid(algorithm_type algorithm) {
+    // Kernel includes all options which change the iteration counts, and whether periods are saved
+    cache_key.spacing_x = span_x / width;
+    cache_key.spacing_y = span_y / height;
+    cache_key.max_iteration = max_iteration;
+    cache_key.kernel = algorithm | (chosen_scalar(algorithm) << 4) | ((tolerance > 0) << 8) | (interior_check << 9)
+        | (series_approximation << 10) | (period_output << 11);
+
+    cache_axis(center_x, span_x, width, ilogb(cache_key.spacing_x), cache_column_position, cache_columns, cache_column_origins);
+    cache_axis(center_y, span_y, height, ilogb(cache_key.spacing_y), cache_row_position, cache_rows, cache_row_origins);
+}
+
+tile_key MandelbrotSet::cache_tile_key(int a, int b) {
+    tile_key key = cache_key;
+    key.origin = (cache_column_origins[a] * 1099511628211ULL) ^ cache_row_origins[b];
+    return key;
+}
+
+// Filling the points of the rendering which are in the tile cache
+// Every point looks in the cell of the grid it lies in, and reuses the point saved there if it is within the tolerance of
+// reprojection, so points are found whenever the same points are rendered again with the same precision and kernel:
+// zooming out to a plot whose colors were evicted from the stack, going back to an earlier precision, panning over
+// points which were rendered before, or rendering again after a cancelled rendering
+void MandelbrotSet::fill_from_cache(algorithm_type algorithm) {
+    cached_points = 0;
+    caching = cache_enabled && algorithm != UNOPTIMIZED && algorithm != SUBDIVISION
+        && algorithm != DISTANCE;
+    if(!caching) return;
+    this -> cache_grid(algorithm);
+
+    // Tolerance in cells
+    double tolerance_x = ldexp(reprojection_tolerance * cache_key.spacing_x, -ilogb(cache_key.spacing_x));
+    double tolerance_y = ldexp(reprojection_tolerance * cache_key.spacing_y, -ilogb(cache_key.spacing_y));
+    long long found = 0;
+
+    // Window is gone through tile by tile of the cache
+    for(size_t b = 0; b + 1 < cache_rows.size(); b ++) {
+        int j_start = cache_rows[b];
+        int j_end = cache_rows[b + 1];
+        for(size_t a = 0; a + 1 < cache_columns.size(); a ++) {
+            int i_start = cache_columns[a];
+            int i_end = cache_columns[a + 1];
+            const tile_data* data = cache.find(this -> cache_tile_key(a, b));
+            if(data == NULL) continue;
+
+            for(int j = j_start; j < j_end; j ++) {
+                int row = (int)cache_row_position[j] * CACHE_TILE;
+                for(int i = i_start; i < i_end; i ++) {
+                    int cell = row + (int)cache_column_position[i];
+                    if(data -> x[cell] < 0 || fabs(data -> x[cell] - cache_column_position[i]) > tolerance_x
+                       || fabs(data -> y[cell] - cache_row_position[j]) > tolerance_y) continue;
+
+                    if(!reusing) {
+                        reuse_source.assign(width * height, -1);
+                        reusing = true;
+                    }
+                    int k = j*width + i;
+                    // Points reused from the previous rendering are already counted
+                    if(reuse_source[k] < 0) cached_points ++;
+                    iterations[k] = data -> iterations[cell];
+                    if(algorithm == CONTINUOUS) fractions[k] = data -> fractions[cell];
+                    if(period_output) periods[k] = data -> periods[cell];
+                    // Orbits are not cached, so points which did not escape cannot be continued
+                    if(iterations[k] == max_iteration) have_orbits = false;
+                    reuse_source[k] = k;
+                    found ++;
                 }
+            }
+        }
+    }
+    cache.count(found, (long long)width * height - found);
+}
+
+// Adding the points iterated by the finished rendering to the cache (points which reused the count of a nearby point
+// are not added, so saved points are always at the position they were iterated at)
+void MandelbrotSet::store_in_cache() {
+    bool with_fractions = (cache_key.kernel & 15) == CONTINUOUS;
 
-                // Period to update xold and yold set as max_iteration / 10
-                period ++;
-                if(period > max_iteration / 10.0f) {
-                    period = 0;
-                    xold = x;
-                    yold = y;
+    for(size_t b = 0; b + 1 < cache_rows.size(); b ++) {
+        int j_start = cache_rows[b];
+        int j_end = cache_rows[b + 1];
+        for(size_t a = 0; a + 1 < cache_columns.size(); a ++) {
+            int i_start = cache_columns[a];
+            int i_end = cache_columns[a + 1];
+            tile_data& data = cache.update(this -> cache_tile_key(a, b), with_fractions, period_output);
+
+            for(int j = j_start; j < j_end; j ++) {
+                int row = (int)cache_row_position[j] * CACHE_TILE;
+                for(int i = i_start; i < i_end; i ++) {
+                    int k = j*width + i;
+                    if(this -> is_reused(k)) continue;
+                    int cell = row + (int)cache_column_position[i];
+                    data.x[cell] = cache_column_position[i];
+                    data.y[cell] = cache_row_position[j];
+                    data.iterations[cell] = iterations[k];
+                    if(with_fractions) data.fractions[cell] = fractions[k];
+                    if(period_output) data.periods[cell] = periods[k];
                 }
             }
+        }
+    }
+}
+
+// Checking whether a point reused its iteration count (so that it does not have to be iterated)
+bool MandelbrotSet::is_reused(int k) {
+    return reusing && reuse_source[k] >= 0;
+}
+
+// Tolerance of cycle detection scales with the distance between adjacent points, so that it stays well below
+// the size of a point at every zoom (a fixed tolerance would be too coarse in deep zooms and too fine far out)
+double MandelbrotSet::cycle_tolerance(algorithm_type algorithm) {
+    if(!cycle_detection && algorithm != PERIODIC) return 0;
+    double spacing = min((lim_r - lim_l) / width, (lim_t - lim_b) / height);
+    return spacing * CYCLE_TOLERANCE;
+}
+
+// Iterating a probe of PROBE_SIZE x PROBE_SIZE points spread evenly over the view (in doubles, in parallel rows) to
+// predict the iterations of a rendering: points which escape take the same iterations with and without cycle detection,
+// periodic points are cut short by it, and points skipped by the interior check take none
+render_probe MandelbrotSet::probe() {
+    vector<double> plain(PROBE_SIZE, 0);
+    vector<double> periodic(PROBE_SIZE, 0);
+    double probe_tolerance = min((lim_r - lim_l) / width, (lim_t - lim_b) / height) * CYCLE_TOLERANCE;
 
-            // Point at (i,j) colored with iteration (mod p) element of the color palette
-            points[i*width + j].position = sf::Vector2f(i, j);
-            points[i*width + j].color = palette[iteration % p];
+    pool.parallel_for(PROBE_SIZE, [&](int row) {
+        double y0 = lim_b + (lim_t - lim_b) * (row + 0.5) / PROBE_SIZE;
+        for(int column = 0; column < PROBE_SIZE; column ++) {
+            double x0 = lim_l + (lim_r - lim_l) * (column + 0.5) / PROBE_SIZE;
+            if(interior_check && in_cardioid_or_bulb(x0, y0) > 0) continue;
+            orbit_state z = orbit_state();
+            int period = 0;
+            int iteration = optimized_orbit(x0, y0, z, 0, max_iteration, probe_tolerance, period);
+            plain[row] += iteration;
+            periodic[row] += period > 0 ? z.saved_at + period : iteration;
         }
+    });
+
+    // Iterations of the probe scaled to all points of the view
+    render_probe result;
+    double scale = (double)width * height / (PROBE_SIZE * PROBE_SIZE);
+    result.iterations = 0;
+    result.periodic_iterations = 0;
+    for(int row = 0; row < PROBE_SIZE; row ++) {
+        result.iterations += plain[row] * scale;
+        result.periodic_iterations += periodic[row] * scale;
     }
+    return result;
+}
 
-    // Add the plot created to the stack if addToStack variable is true
-    if(addToStack) {
-        pixels_data* new_elem = new pixels_data;
-        new_elem -> points = points;
-        new_elem -> lim_l = lim_l;
-        new_elem -> lim_r = lim_r;
-        new_elem -> lim_t = lim_t;
-        new_elem -> lim_b = lim_b;
-        new_elem -> zoom = zoom;
-        st.push(new_elem);
+// Work of an algorithm predicted by the probe: its iterations (with cycle detection if it uses it), and the cost of
+// every point of the view besides them
+double MandelbrotSet::probe_work(algorithm_type algorithm, const render_probe& probe) {
+    double work = cycle_tolerance(algorithm) > 0 ? probe.periodic_iterations : probe.iterations;
+    return work + (double)width * height * POINT_COST;
+}
+
+// Time of an algorithm predicted by the cost model, in the scalar type it would use in this view, on all threads
+double MandelbrotSet::predicted_seconds(algorithm_type algorithm, const render_probe& probe) {
+    return this -> probe_work(algorithm, probe) * iteration_seconds[algorithm][chosen_scalar(algorithm)] / this -> get_threads();
+}
+
+// Running an algorithm and updating the cost model with its time per iteration (the mean of the old cost and the new
+// one, so that it follows changes of the machine's load without jumping at every rendering)
+// Renderings which were cancelled, or which reused points of the previous rendering or the tile cache, did not do the
+// predicted work, so they are not used
+void MandelbrotSet::timed_algorithm(algorithm_type algorithm, bool addToStack, const render_probe& probe) {
+    auto start = chrono::steady_clock::now();
+    this -> run_algorithm(algorithm, addToStack);
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    if(cancel_requested || reusing) return;
+    double& cost = iteration_seconds[algorithm][last_scalar];
+    cost = 0.5 * cost + 0.5 * seconds * this -> get_threads() / this -> probe_work(algorithm, probe);
+}
+
+// Rendering the algorithm chosen by AUTO within the time budget
+// If the probe predicts that it fits in the budget, it is rendered directly, without the previews of progressive
+// passes (which cost time and are not needed); if nothing is shown before the rendering is finished (no preview
+// listener), there is nothing else to do
+// Else a quick frame is rendered with the faster of the vectorized and periodic algorithms (escape coloring), and shown
+// as a preview; if even it does not fit, the periodic algorithm is rendered progressively, so previews at reduced
+// resolution (1/16 of the points after the first pass) are shown within the budget
+// The chosen algorithm then refines the quick frame in the background (on the rendering thread, till a newer rendering
+// cancels it), so the finished plot is the same as without a budget
+void MandelbrotSet::scheduled_algorithm(algorithm_type chosen, bool addToStack) {
+    render_probe probe = this -> probe();
+    predicted_time = this -> predicted_seconds(chosen, probe);
+    quick_algorithm = AUTO;
+    bool was_progressive = progressive;
+
+    if(predicted_time <= time_budget || !preview_listener) {
+        progressive = progressive && predicted_time > time_budget;
+        this -> timed_algorithm(chosen, addToStack, probe);
+        progressive = was_progressive;
+        return;
     }
+
+    algorithm_type quick = this -> predicted_seconds(VECTORIZED, probe) < this -> predicted_seconds(PERIODIC, probe) ? VECTORIZED : PERIODIC;
+    bool reduced = this -> predicted_seconds(quick, probe) > time_budget;
+    if(reduced) quick = PERIODIC;
+    // The chosen algorithm is the quick one, so it is its own refinement
+    if(quick == chosen) {
+        progressive = reduced;
+        this -> timed_algorithm(chosen, addToStack, probe);
+        progressive = was_progressive;
+        return;
+    }
+    quick_algorithm = quick;
+
+    // The rendering before the quick frame is kept as the previous rendering, so the refinement can reuse its iteration
+    // counts (the quick frame uses another algorithm, so it could not), and the quick frame does not reproject it
+    this -> save_previous();
+    bool was_reprojection = reprojection;
+    reprojection = false;
+    progressive = reduced;
+    this -> timed_algorithm(quick, false, probe);
+    reprojection = was_reprojection;
+    progressive = false;
+
+    if(!cancel_requested) {
+        preview_listener();
+        // The refinement's own preview (reprojected from the rendering before the quick frame) would be worse than the
+        // quick frame, so it is not shown
+        have_iterations = false;
+        function<void()> listener = preview_listener;
+        preview_listener = function<void()>();
+        this -> timed_algorithm(chosen, addToStack, probe);
+        preview_listener = listener;
+    }
+    // A rendering stopped during the quick frame is still pushed to the stack (only its view), as if it was stopped
+    // during the chosen algorithm
+    else this -> save_rendering(addToStack);
+    progressive = was_progressive;
 }
 
-void MandelbrotSet::histogramColoring(bool addToStack) {
+// Adding the orbits of the points of a tile which did not escape to the list of orbits (called from all threads)
+void MandelbrotSet::save_orbits(vector<orbit_state>& tile_orbits) {
+    if(tile_orbits.empty()) return;
+    lock_guard<mutex> guard(orbits_lock);
+    orbits.insert(orbits.end(), tile_orbits.begin(), tile_orbits.end());
+}
 
-    // Maintaining a 2D array consisting of iterations for all points
-    vector<vector<int> > iterations(width, vector<int>(height));
-    // Map of iterations (number of points having some iteration count)
-    vector<int> map_iterations(max_iteration + 1, 0);
+// Continue the orbits of all points which did not escape in the last rendering till max_iteration
+// Points which escaped earlier keep their iteration counts, so only the new iterations are computed
+void MandelbrotSet::resume_orbits(int old_max_iteration) {
+    TELEMETRY_START(width * height, (width + TILE_SIZE - 1) / TILE_SIZE, (height + TILE_SIZE - 1) / TILE_SIZE);
+    // Points which were not iterated till old_max_iteration (found inside the Set by the interior or periodicity check)
+    // stay inside the Set, so their iteration count becomes max_iteration
+    // Saved orbits also have old_max_iteration, and are continued below
+    for(int k = 0; k < width * height; k ++) {
+        if(iterations[k] == old_max_iteration) iterations[k] = max_iteration;
+    }
 
-    for(int i = 0; i < width; i ++) {
-        for(int  j = 0; j < height; j ++) {
-            // Find point (x0,y0) in the limits corresponding to (i,j)
-            // Complex number c = x0 + iy0
+    // Points found in the tile cache (if this precision was rendered before) are not continued
+    reusing = false;
+    reused_points = 0;
+    this -> fill_from_cache(orbits_algorithm);
+    if(reusing) {
+        int n = 0;
+        for(size_t k = 0; k < orbits.size(); k ++) {
+            if(!this -> is_reused(orbits[k].j * width + orbits[k].i)) orbits[n ++] = orbits[k];
+        }
+        orbits.resize(n);
+    }
+
+    // Orbits are split into chunks of ORBIT_CHUNK, which are continued in parallel
+    const int ORBIT_CHUNK = 1024;
+    int chunks = (orbits.size() + ORBIT_CHUNK - 1) / ORBIT_CHUNK;
+
+    work_done = 0;
+    work_total = orbits.size();
+    rendered_max_iteration = max_iteration;
+
+    pool.parallel_for(chunks, [&](int chunk) {
+        if(cancel_requested) return;
+        int k_end = min((int)orbits.size(), (chunk + 1) * ORBIT_CHUNK);
+        TELEMETRY_COUNTERS(counters);
+        for(int k = chunk * ORBIT_CHUNK; k < k_end; k ++) {
+            orbit_state& z = orbits[k];
+            int i = z.i;
+            int j = z.j;
+            // Same point (x0,y0) in the limits corresponding to (i,j) as in the rendering
             double x0 = lim_l + ((lim_r - lim_l) * i) / width;
             double y0 = lim_b + ((lim_t - lim_b) * j) / height;
-            // Complex number z = x + iy
-            double x = 0;
-            double y = 0;
-            // To reduce computations, maintaining variables x2 = x^2 and y2 = y^2
-            double x2 = 0;
-            double y2 = 0;
-
-            // Number of iterations required for z to get outside circle centered at origin of radius 2
-            int iteration = 0;
-            while(x2 + y2 <= 4 && iteration < max_iteration) {
-                // New values of x and y found as x = Re(z^2 + c) and y = Im(z^2 + c)
-                y = (x + x) * y + y0;
-                x = x2 - y2 + x0;
-                x2 = x * x;
-                y2 = y * y;
-                iteration ++;
+            // Number of iterations already done by the point (cycle detection also continues from its saved state)
+            int iteration = old_max_iteration;
+            int period = 0;
+
+            if(orbits_algorithm == UNOPTIMIZED) iteration = unoptimized_orbit(x0, y0, z, iteration, max_iteration, tolerance, period);
+            else if(orbits_algorithm == CONTINUOUS) iteration = continuous_orbit(x0, y0, z, iteration, max_iteration, tolerance, period);
+            else if(last_scalar == SCALAR_FLOAT) iteration = optimized_orbit((float)x0, (float)y0, z, iteration, max_iteration, tolerance, period);
+            else iteration = optimized_orbit(x0, y0, z, iteration, max_iteration, tolerance, period);
+            TELEMETRY_POINT(counters, j*width + i, old_max_iteration, iteration, period, z.saved_at);
+
+            if(orbits_algorithm == CONTINUOUS && iteration < max_iteration) {
+                double new_it = smooth_iteration(z.x * z.x + z.y * z.y, iteration);
+                iteration = (int) new_it;
+                fractions[j*width + i] = new_it - iteration;
             }
-            // Iteration count for (i,j) updated in 2D array and map
-            iterations[i][j] = iteration;
-            map_iterations[iteration] ++;
+            iterations[j*width + i] = iteration;
+            if(period_output) periods[j*width + i] = period;
+
+            // Points which escaped (or were found to be periodic) do not have to be continued again
+            if(iteration < max_iteration || period > 0) z.i = -1;
         }
+        work_done += k_end - chunk * ORBIT_CHUNK;
+        TELEMETRY_ADD(counters);
+    });
+
+    // Removing orbits which are finished
+    int n = 0;
+    for(size_t k = 0; k < orbits.size(); k ++) {
+        if(orbits[k].i != -1) orbits[n ++] = orbits[k];
     }
+    orbits.resize(n);
 
+    // Points of a resumed rendering which was not cancelled are cached
+    if(caching && !cancel_requested) this -> store_in_cache();
+    caching = false;
 
-    for(int i = 0; i < width; i ++) {
-        for(int  j = 0; j < height; j ++) {
-            // Finding number of vertices which have iteration count less than iteration count for (i,j)
-            int iteration = iterations[i][j];
-            int iter = 0;
-            for(int k = 0; k <= iteration; k ++) {
-                iter += map_iterations[k];
+    // Colors found again from the updated iteration counts
+    this -> recolor();
+    TELEMETRY_FINISH();
+}
+
+void MandelbrotSet::unoptimizedEscapeTime(bool addToStack) {
+    this -> start_rendering(UNOPTIMIZED);
+
+    render_tiles([&](int i_start, int i_end, int j_start, int j_end) {
+        // Orbits of points of this tile which do not escape
+        vector<orbit_state> tile_orbits;
+        // Number of points of this tile skipped by the interior check
+        long long skipped = 0;
+        TELEMETRY_COUNTERS(counters);
+
+        for(int j = j_start; j < j_end; j ++) {
+            for(int i = i_start; i < i_end; i ++) {
+                // Find point (x0,y0) in the limits corresponding to (i,j)
+                // Complex number c = x0 + iy0
+                double x0 = lim_l + ((lim_r - lim_l) * i) / width;
+                double y0 = lim_b + ((lim_t - lim_b) * j) / height;
+                // Points in the main cardioid or the period-2 bulb never escape, so they are not iterated
+                int interior_period = interior_check ? in_cardioid_or_bulb(x0, y0) : 0;
+                if(interior_period > 0) {
+                    iterations[j*width + i] = max_iteration;
+                    if(period_output) periods[j*width + i] = interior_period;
+                    skipped ++;
+                    continue;
+                }
+                // Complex number z = x + iy, starting at 0
+                orbit_state z = orbit_state();
+
+                // Number of iterations required for z to get outside circle centered at origin of radius 2
+                int period = 0;
+                int iteration = unoptimized_orbit(x0, y0, z, 0, max_iteration, tolerance, period);
+                TELEMETRY_POINT(counters, j*width + i, 0, iteration, period, z.saved_at);
+
+                // Iteration count for (i,j) saved in the buffer (colored later by recolor)
+                iterations[j*width + i] = iteration;
+                if(period_output) periods[j*width + i] = period;
+                // If z did not escape (and was not found to be periodic), then its orbit is saved
+                // so that it can be continued on increasing precision
+                if(iteration == max_iteration && period == 0) {
+                    z.i = i;
+                    z.j = j;
+                    tile_orbits.push_back(z);
+                }
             }
+        }
+        this -> save_orbits(tile_orbits);
+        interior_skipped += skipped;
+        TELEMETRY_ADD(counters);
+    });
+
+    // Point at (i,j) colored with iteration (mod p) element of the color palette
+    coloring = ESCAPE_COLORING;
+    this -> recolor();
+    this -> save_rendering(addToStack);
+}
+
+// Finding the pass of a progressive rendering in which point (i,j) is iterated
+static inline int progressive_pass(int i, int j) {
+    if(i % 4 == 0 && j % 4 == 0) return 0;
+    if(i % 2 == 0 && j % 2 == 0) return 1;
+    if((i + j) % 2 == 0) return 2;
+    return 3;
+}
+
+// Rendering all points (or only the points of a pass of a progressive rendering) with the optimized escape time
+// iteration in scalar type T
+template<typename T>
+void MandelbrotSet::scalar_tiles(bool interior, int pass) {
+    // Center of the view in T (used by the types more precise than doubles)
+    T cx = from_big_number<T>(center_x);
+    T cy = from_big_number<T>(center_y);
 
-            // Point at (i,j) colored with (no. of vertices found) (mod p) element of the color palette
-            points[i*width + j].position = sf::Vector2f(i, j);
-            points[i*width + j].color = palette[iter % p];
+    render_tiles([&](int i_start, int i_end, int j_start, int j_end) {
+        // Orbits of points of this tile which do not escape
+        vector<orbit_state> tile_orbits;
+        // Number of points of this tile skipped by the interior check
+        long long skipped = 0;
+        TELEMETRY_COUNTERS(counters);
+
+        // Only the points of this pass are visited (tiles start at multiples of TILE_SIZE, so the grids of step 4 and 2
+        // start at the corner of every tile): every 4th point of every 4th row in the first pass, every 2nd point of every
+        // 2nd row in the second, odd points of odd rows in the third, and the rest (i + j odd) in the last
+        int step = pass == 0 ? 4 : (pass > 0 ? 2 : 1);
+        for(int j = j_start + (pass == 2 ? 1 : 0); j < j_end; j += (pass == 3 ? 1 : step)) {
+            for(int i = i_start + (pass == 2 || (pass == 3 && j % 2 == 0) ? 1 : 0); i < i_end; i += step) {
+                // Points of the first pass are also on the grid of the second pass
+                if(pass == 1 && progressive_pass(i, j) != 1) continue;
+                // Points reused from the previous rendering already have their iteration counts
+                if(this -> is_reused(j*width + i)) continue;
+                // Find point (x0,y0) in the limits corresponding to (i,j)
+                // Complex number c = x0 + iy0
+                T x0 = point_coordinate<T>(cx, lim_l, lim_r, span_x, i, width);
+                T y0 = point_coordinate<T>(cy, lim_b, lim_t, span_y, j, height);
+                // Points in the main cardioid or the period-2 bulb never escape, so they are not iterated
+                int interior_period = interior ? in_cardioid_or_bulb(to_double(x0), to_double(y0)) : 0;
+                if(interior_period > 0) {
+                    iterations[j*width + i] = max_iteration;
+                    if(period_output) periods[j*width + i] = interior_period;
+                    skipped ++;
+                    continue;
+                }
+                // Complex number z = x + iy, starting at 0
+                // xold and yold (value of z saved for cycle detection) also start at 0
+                orbit_state z = orbit_state();
+
+                // Number of iterations required for z to get outside circle centered at origin of radius 2
+                // If cycle detection is used and z comes back (within tolerance) to a saved value, then (i,j) is part
+                // of the Set, and its iteration count is max_iteration without iterating further
+                int period = 0;
+                int iteration = optimized_orbit(x0, y0, z, 0, max_iteration, tolerance, period);
+                TELEMETRY_POINT(counters, j*width + i, 0, iteration, period, z.saved_at);
+
+                // Iteration count for (i,j) saved in the buffer (colored later by recolor)
+                iterations[j*width + i] = iteration;
+                if(period_output) periods[j*width + i] = period;
+                // If z did not escape (and was not found to be periodic), then its orbit is saved
+                // so that it can be continued on increasing precision
+                if(iteration == max_iteration && period == 0) {
+                    z.i = i;
+                    z.j = j;
+                    tile_orbits.push_back(z);
+                }
+            }
         }
+        this -> save_orbits(tile_orbits);
+        interior_skipped += skipped;
+        TELEMETRY_ADD(counters);
+    });
+}
+
+// Rendering all points with the optimized escape time iteration in the scalar type chosen for the algorithm
+// A progressive rendering iterates the points in PROGRESSIVE_PASSES passes, and shows a preview after every pass but the
+// last, so a coarse plot is shown after about 1/16 of the work; the last pass completes exactly the same plot
+void MandelbrotSet::scalar_render(algorithm_type algorithm) {
+    last_scalar = chosen_scalar(algorithm);
+    // The preview reprojected from the previous rendering is better than the first passes, so they are not shown after it
+    int passes = progressive && !reprojected ? PROGRESSIVE_PASSES : 1;
+    // Every pass goes through all tiles
+    work_total = passes * work_total;
+
+    for(int k = 0; k < passes; k ++) {
+        int pass = progressive ? k : -1;
+        // The interior check is done in doubles, so it is left out for the more precise types (which are only chosen when
+        // doubles cannot tell adjacent points apart)
+        if(last_scalar == SCALAR_FLOAT) this -> scalar_tiles<float>(interior_check, pass);
+        else if(last_scalar == SCALAR_LONG_DOUBLE) this -> scalar_tiles<long double>(false, pass);
+        else if(last_scalar == SCALAR_DOUBLE_DOUBLE) this -> scalar_tiles<double_double>(false, pass);
+#ifdef MANDELBROT_FIXED128
+        else if(last_scalar == SCALAR_FIXED128) this -> scalar_tiles<fixed128>(false, pass);
+#endif
+        else this -> scalar_tiles<double>(interior_check, pass);
+
+        if(cancel_requested) break;
+        if(k < passes - 1) this -> show_preview(k, algorithm == HISTOGRAM ? HISTOGRAM_COLORING : ESCAPE_COLORING);
     }
 
-    // Add the plot created to the stack if addToStack variable is true
-    if(addToStack) {
-        pixels_data* new_elem = new pixels_data;
-        new_elem -> points = points;
-        new_elem -> lim_l = lim_l;
-        new_elem -> lim_r = lim_r;
-        new_elem -> lim_t = lim_t;
-        new_elem -> lim_b = lim_b;
-        new_elem -> zoom = zoom;
-        st.push(new_elem);
+    // Orbits are saved as doubles, which is exact only for floats and doubles, so orbits in the other types cannot be
+    // continued and increasing precision renders the Set again
+    if(last_scalar != SCALAR_FLOAT && last_scalar != SCALAR_DOUBLE) {
+        have_orbits = false;
+        orbits.clear();
     }
 }
 
-// Given c1 and c2 on the number line, find point dividing the line segment between them in (1-t):t ratio
-double linear_interpolation(double c1, double c2, double t) {
-    return (1-t)*c1 + t*c2;
+// Coloring the points iterated in the passes up to pass of a progressive rendering, and giving each color also to the
+// points which are not iterated yet next to it: the square of the grid of step 4 (after the first pass) or 2 (after the
+// second) whose corner it is, and its right neighbour after the checkerboard (points in the first column, which are not
+// on the checkerboard in odd rows, take the color of their upper neighbour)
+// Only the iterated points are colored, so a preview costs a fraction of a full recolor; histogram coloring uses a
+// histogram of the iterated points, scaled to all points
+void MandelbrotSet::show_preview(int pass, coloring_type preview_coloring) {
+    TELEMETRY_PHASE(PHASE_COLORING);
+    // Step of the grid of iterated points in the first two passes
+    int step = pass == 0 ? 4 : 2;
+    // Number of iterated points, and the iteration counts at which they are colored
+    long long samples = 0;
+    vector<int> cumulative;
+    // Coloring a preview is not counted in the progress of the rendering
+    long long done = work_done;
+
+    if(preview_coloring == HISTOGRAM_COLORING) {
+        vector<int> histogram(max_iteration + 1, 0);
+        for(int j = 0; j < height; j += (pass < 2 ? step : 1)) {
+            for(int i = (pass < 2 ? 0 : j % 2); i < width; i += step) {
+                histogram[iterations[j*width + i]] ++;
+                samples ++;
+            }
+        }
+        // Cumulative counts are scaled from the iterated points to all points
+        cumulative.assign(max_iteration + 1, 0);
+        long long total = 0;
+        for(int k = 0; k <= max_iteration; k ++) {
+            total += histogram[k];
+            cumulative[k] = (int)(total * width * height / samples);
+        }
+    }
+
+    render_tiles([&](int i_start, int i_end, int j_start, int j_end) {
+        for(int j = j_start; j < j_end; j += (pass < 2 ? step : 1)) {
+            for(int i = i_start + (pass < 2 ? 0 : j % 2); i < i_end; i += step) {
+                // Same color as given by recolor, with the coloring of the algorithm
+                int iteration = iterations[j*width + i];
+                int iter = preview_coloring == HISTOGRAM_COLORING ? cumulative[iteration] : iteration;
+                sf::Color color = palette[iter % p];
+
+                if(pass < 2) {
+                    for(int y = j; y < min(j + step, j_end); y ++) {
+                        for(int x = i; x < min(i + step, i_end); x ++) {
+                            framebuffer[y*width + x] = color;
+                        }
+                    }
+                }
+                else {
+                    framebuffer[j*width + i] = color;
+                    if(i + 1 < width) framebuffer[j*width + i + 1] = color;
+                    if(i == 0 && j + 1 < j_end) framebuffer[(j + 1) * width] = color;
+                }
+            }
+        }
+    });
+
+    work_done = done;
+    if(cancel_requested) return;
+    dirty = true;
+    if(preview_listener) preview_listener();
+}
+
+void MandelbrotSet::optimizedEscapeTime(bool addToStack) {
+    this -> start_rendering(OPTIMIZED);
+    this -> scalar_render(OPTIMIZED);
+
+    // Point at (i,j) colored with iteration (mod p) element of the color palette
+    coloring = ESCAPE_COLORING;
+    this -> recolor();
+    this -> save_rendering(addToStack);
+}
+
+void MandelbrotSet::periodicallyCheckedEscapeTime(bool addToStack) {
+    // Same as the optimized escape time algorithm, with cycle detection (tolerance is set by start_rendering)
+    this -> start_rendering(PERIODIC);
+    this -> scalar_render(PERIODIC);
+
+    // Point at (i,j) colored with iteration (mod p) element of the color palette
+    coloring = ESCAPE_COLORING;
+    this -> recolor();
+    this -> save_rendering(addToStack);
+}
+
+void MandelbrotSet::histogramColoring(bool addToStack) {
+    this -> start_rendering(HISTOGRAM);
+    // Find the iteration count of every point (in parallel)
+    this -> scalar_render(HISTOGRAM);
+
+    // Points are colored by recolor, using the number of points having at most some iteration count
+    coloring = HISTOGRAM_COLORING;
+    this -> recolor();
+    this -> save_rendering(addToStack);
 }
 
 void MandelbrotSet::continuousColoring(bool addToStack) {
-    for(int i = 0; i < width; i ++) {
-        for(int  j = 0; j < height; j ++) {
-            // Find point (x0,y0) in the limits corresponding to (i,j)
-            double x0 = lim_l + ((lim_r - lim_l) * i) / width;
-            double y0 = lim_b + ((lim_t - lim_b) * j) / height;
-            double x = 0;
-            double y = 0;
-
-            // Instead of the discrete version, using logarithms to perform escape time algorithms
-            int iteration = 0;
-            while(x * x + y * y <= (1 << 16) && iteration < max_iteration) {
-                double xtemp = x * x - y * y + x0;
-                y = (x + x) * y + y0;
-                x = xtemp;
-                iteration ++;
+    this -> start_rendering(CONTINUOUS);
+
+    render_tiles([&](int i_start, int i_end, int j_start, int j_end) {
+        // Orbits of points of this tile which do not escape
+        vector<orbit_state> tile_orbits;
+        // Number of points of this tile skipped by the interior check
+        long long skipped = 0;
+        TELEMETRY_COUNTERS(counters);
+        // Points of the current row which escaped: their index, iteration count and |z|^2 after escaping
+        // Their smooth iteration counts are found together at the end of the row, in a loop without calls (which the
+        // compiler can vectorize), instead of one point at a time between orbits
+        int escaped_index[TILE_SIZE];
+        int escaped_iteration[TILE_SIZE];
+        double escaped_radius[TILE_SIZE];
+        double smooth[TILE_SIZE];
+
+        for(int j = j_start; j < j_end; j ++) {
+            int escaped = 0;
+            for(int i = i_start; i < i_end; i ++) {
+                // Points reused from the previous rendering already have their iteration counts
+                if(this -> is_reused(j*width + i)) continue;
+                // Find point (x0,y0) in the limits corresponding to (i,j)
+                double x0 = lim_l + ((lim_r - lim_l) * i) / width;
+                double y0 = lim_b + ((lim_t - lim_b) * j) / height;
+                // Points in the main cardioid or the period-2 bulb never escape, so they are not iterated
+                int interior_period = interior_check ? in_cardioid_or_bulb(x0, y0) : 0;
+                if(interior_period > 0) {
+                    iterations[j*width + i] = max_iteration;
+                    fractions[j*width + i] = 0;
+                    if(period_output) periods[j*width + i] = interior_period;
+                    skipped ++;
+                    continue;
+                }
+
+                orbit_state z = orbit_state();
+
+                // Instead of the discrete version, using logarithms to perform escape time algorithms
+                int period = 0;
+                int iteration = continuous_orbit(x0, y0, z, 0, max_iteration, tolerance, period);
+                TELEMETRY_POINT(counters, j*width + i, 0, iteration, period, z.saved_at);
+                if(period_output) periods[j*width + i] = period;
+
+                if(iteration < max_iteration) {
+                    escaped_index[escaped] = j*width + i;
+                    escaped_iteration[escaped] = iteration;
+                    escaped_radius[escaped] = z.x * z.x + z.y * z.y;
+                    escaped ++;
+                    continue;
+                }
+                // If z did not escape (and was not found to be periodic), then its orbit is saved
+                // so that it can be continued on increasing precision
+                if(period == 0) {
+                    z.i = i;
+                    z.j = j;
+                    tile_orbits.push_back(z);
+                }
+                // Points inside the Set keep iteration = max_iteration
+                iterations[j*width + i] = iteration;
+                fractions[j*width + i] = 0;
             }
 
-            double new_it = 0;
+            // Integer and fractional part of new iterations of the escaped points saved in the buffers
+            for(int n = 0; n < escaped; n ++) {
+                smooth[n] = smooth_iteration(escaped_radius[n], escaped_iteration[n]);
+            }
+            for(int n = 0; n < escaped; n ++) {
+                int iteration = (int) smooth[n];
+                iterations[escaped_index[n]] = iteration;
+                fractions[escaped_index[n]] = smooth[n] - iteration;
+            }
+        }
+        this -> save_orbits(tile_orbits);
+        interior_skipped += skipped;
+        TELEMETRY_ADD(counters);
+    });
 
-            if(iteration < max_iteration) {
-                double z = log(x * x + y * y) / 2;
-                double mu = log(z / log(2)) / log(2);
-                // New iterations are no longer an integer
-                new_it = (double)iteration + 1 - mu;
-                iteration = (int) new_it;
+    // Finding the color between the colors of the two integers around new iterations
+    coloring = CONTINUOUS_COLORING;
+    this -> recolor();
+    this -> save_rendering(addToStack);
+}
+
+void MandelbrotSet::vectorizedEscapeTime(bool addToStack) {
+    this -> start_rendering(VECTORIZED);
+    scalar_type type = chosen_scalar(VECTORIZED);
+
+    // Vector instructions work only on floats and doubles, so points are iterated one by one in the more precise types
+    if(type != SCALAR_FLOAT && type != SCALAR_DOUBLE) this -> scalar_render(VECTORIZED);
+    else render_tiles([&](int i_start, int i_end, int j_start, int j_end) {
+        // Points (i_start, j), ..., (i_end - 1, j) of a row of the tile are iterated together (in floats or doubles)
+        // Points skipped by the interior check are left out, so that all lanes do useful work
+        double x0[TILE_SIZE];
+        double y0[TILE_SIZE];
+        float x0_float[TILE_SIZE];
+        float y0_float[TILE_SIZE];
+        // Column i of the points which are iterated, their iteration counts, last values of z = x + iy,
+        // and values of z saved by cycle detection (with the periods found by it, and the iterations at which the values
+        // of z periodic orbits came back to were saved)
+        int column[TILE_SIZE];
+        int lane_iterations[TILE_SIZE];
+        double x[TILE_SIZE];
+        double y[TILE_SIZE];
+        double xold[TILE_SIZE];
+        double yold[TILE_SIZE];
+        int lane_periods[TILE_SIZE];
+        int lane_saved_at[TILE_SIZE];
+        simd_output out;
+        out.x = x;
+        out.y = y;
+        out.xold = xold;
+        out.yold = yold;
+        out.periods = lane_periods;
+        out.saved_at = lane_saved_at;
+        // Orbits which did not escape have done max_iteration iterations, so cycle detection last saved z
+        // at the largest power of 2 not above max_iteration
+        int saved_at = 1;
+        while(2 * saved_at <= max_iteration) saved_at *= 2;
+        // Orbits of points of this tile which do not escape
+        vector<orbit_state> tile_orbits;
+        // Number of points of this tile skipped by the interior check
+        long long skipped = 0;
+        TELEMETRY_COUNTERS(counters);
+
+        for(int j = j_start; j < j_end; j ++) {
+            // Find points (x0,y0) in the limits corresponding to (i,j)
+            int n = 0;
+            for(int i = i_start; i < i_end; i ++) {
+                // Points reused from the previous rendering already have their iteration counts
+                if(this -> is_reused(j*width + i)) continue;
+                double x_i = lim_l + ((lim_r - lim_l) * i) / width;
+                double y_i = lim_b + ((lim_t - lim_b) * j) / height;
+
+                // Points in the main cardioid or the period-2 bulb never escape, so they are not iterated
+                int interior_period = interior_check ? in_cardioid_or_bulb(x_i, y_i) : 0;
+                if(interior_period > 0) {
+                    iterations[j*width + i] = max_iteration;
+                    if(period_output) periods[j*width + i] = interior_period;
+                    skipped ++;
+                    continue;
+                }
+                x0[n] = x_i;
+                y0[n] = y_i;
+                x0_float[n] = (float)x_i;
+                y0_float[n] = (float)y_i;
+                column[n ++] = i;
             }
 
-            points[i*width + j].position = sf::Vector2f(i, j);
-            // Finding color corresponding to some integer near new iterations
-            int iter = (int)linear_interpolation(iteration, iteration + 1, new_it - iteration);
-            points[i*width + j].color = palette[iter % p];
+            // Same iteration counts as the optimized escape time algorithm (in the same type), found with vector instructions
+            if(type == SCALAR_FLOAT) simd_escape_time(simd, x0_float, y0_float, n, max_iteration, tolerance, lane_iterations, out);
+            else simd_escape_time(simd, x0, y0, n, max_iteration, tolerance, lane_iterations, out);
+
+            for(int k = 0; k < n; k ++) {
+                int i = column[k];
+                iterations[j*width + i] = lane_iterations[k];
+                TELEMETRY_POINT(counters, j*width + i, 0, lane_iterations[k], lane_periods[k], lane_saved_at[k]);
+                if(period_output) periods[j*width + i] = lane_periods[k];
+
+                // Orbits of points which did not escape (and were not found to be periodic) are saved
+                // so that they can be continued on increasing precision
+                if(lane_iterations[k] == max_iteration && lane_periods[k] == 0) {
+                    orbit_state z = orbit_state();
+                    z.i = i;
+                    z.j = j;
+                    z.x = x[k];
+                    z.y = y[k];
+                    z.xold = xold[k];
+                    z.yold = yold[k];
+                    z.saved_at = saved_at;
+                    tile_orbits.push_back(z);
+                }
+            }
         }
+        this -> save_orbits(tile_orbits);
+        interior_skipped += skipped;
+        TELEMETRY_ADD(counters);
+    });
+    last_scalar = type;
+
+    // Point at (i,j) colored with iteration (mod p) element of the color palette
+    coloring = ESCAPE_COLORING;
+    this -> recolor();
+    this -> save_rendering(addToStack);
+}
+
+// Iterating a single point (i,j) for the subdivision algorithm, in the same way as the optimized escape time algorithm
+int MandelbrotSet::subdivision_point(int i, int j, vector<orbit_state>& rect_orbits) {
+    // Find point (x0,y0) in the limits corresponding to (i,j)
+    double x0 = lim_l + ((lim_r - lim_l) * i) / width;
+    double y0 = lim_b + ((lim_t - lim_b) * j) / height;
+    // Points in the main cardioid or the period-2 bulb never escape, so they are not iterated
+    int interior_period = interior_check ? in_cardioid_or_bulb(x0, y0) : 0;
+    if(interior_period > 0) {
+        iterations[j*width + i] = max_iteration;
+        if(period_output) periods[j*width + i] = interior_period;
+        interior_skipped ++;
+        return max_iteration;
     }
 
-    // Add the plot created to the stack if addToStack variable is true
-    if(addToStack) {
-        pixels_data* new_elem = new pixels_data;
-        new_elem -> points = points;
-        new_elem -> lim_l = lim_l;
-        new_elem -> lim_r = lim_r;
-        new_elem -> lim_t = lim_t;
-        new_elem -> lim_b = lim_b;
-        new_elem -> zoom = zoom;
-        st.push(new_elem);
+    orbit_state z = orbit_state();
+    int period = 0;
+    int iteration = optimized_orbit(x0, y0, z, 0, max_iteration, tolerance, period);
+    // Points are not rendered in tiles here, so every point adds its own counters
+    TELEMETRY_COUNTERS(counters);
+    TELEMETRY_POINT(counters, j*width + i, 0, iteration, period, z.saved_at);
+    TELEMETRY_ADD(counters);
+
+    iterations[j*width + i] = iteration;
+    if(period_output) periods[j*width + i] = period;
+    if(iteration == max_iteration && period == 0) {
+        z.i = i;
+        z.j = j;
+        rect_orbits.push_back(z);
+    }
+    return iteration;
+}
+
+// Rendering a rectangle of points by first iterating the points on its border
+// The Set is connected, so if all points of the border have the same iteration count, then (almost always) all points
+// inside it have that count too, and they are filled without iterating them
+// Otherwise the inside of the rectangle is split into 4 rectangles, which are rendered in the same way
+void MandelbrotSet::subdivide(int i_start, int i_end, int j_start, int j_end) {
+    if(i_start >= i_end || j_start >= j_end || cancel_requested) return;
+    // Orbits of the points of this rectangle (not of its parts) which do not escape
+    vector<orbit_state> rect_orbits;
+
+    // Small rectangles are iterated point by point
+    if(i_end - i_start <= SUBDIVISION_LEAF || j_end - j_start <= SUBDIVISION_LEAF) {
+        for(int j = j_start; j < j_end; j ++) {
+            for(int i = i_start; i < i_end; i ++) {
+                this -> subdivision_point(i, j, rect_orbits);
+            }
+        }
+        this -> save_orbits(rect_orbits);
+        work_done += (long long)(i_end - i_start) * (j_end - j_start);
+        return;
+    }
+
+    // Iterating the points on the top and bottom rows and left and right columns of the rectangle
+    // border is the iteration count of the first point, and uniform is false once some point has another count
+    int border = -1;
+    bool uniform = true;
+    auto border_point = [&](int i, int j) {
+        int iteration = this -> subdivision_point(i, j, rect_orbits);
+        if(border == -1) border = iteration;
+        else if(iteration != border) uniform = false;
+    };
+    for(int i = i_start; i < i_end; i ++) {
+        border_point(i, j_start);
+        border_point(i, j_end - 1);
+    }
+    for(int j = j_start + 1; j < j_end - 1; j ++) {
+        border_point(i_start, j);
+        border_point(i_end - 1, j);
     }
+    this -> save_orbits(rect_orbits);
+    work_done += 2 * (i_end - i_start) + 2 * (j_end - j_start) - 4;
+
+    if(uniform) {
+        // All points inside the rectangle get the iteration count of its border
+        for(int j = j_start + 1; j < j_end - 1; j ++) {
+            for(int i = i_start + 1; i < i_end - 1; i ++) {
+                iterations[j*width + i] = border;
+                if(period_output) periods[j*width + i] = 0;
+            }
+        }
+        filled += (long long)(i_end - i_start - 2) * (j_end - j_start - 2);
+        work_done += (long long)(i_end - i_start - 2) * (j_end - j_start - 2);
+        return;
+    }
+
+    // Splitting the inside of the rectangle at its middle point (the 4 parts do not overlap, so they can be rendered
+    // by different threads), in parallel if the rectangle is large
+    int i_mid = (i_start + i_end) / 2;
+    int j_mid = (j_start + j_end) / 2;
+    int i_bounds[3] = { i_start + 1, i_mid, i_end - 1 };
+    int j_bounds[3] = { j_start + 1, j_mid, j_end - 1 };
+    auto render_part = [&](int part) {
+        int a = part % 2;
+        int b = part / 2;
+        this -> subdivide(i_bounds[a], i_bounds[a + 1], j_bounds[b], j_bounds[b + 1]);
+    };
+    if(i_end - i_start > TILE_SIZE || j_end - j_start > TILE_SIZE) pool.parallel_for(4, render_part);
+    else {
+        for(int part = 0; part < 4; part ++) render_part(part);
+    }
+}
+
+void MandelbrotSet::subdivisionEscapeTime(bool addToStack) {
+    this -> start_rendering(SUBDIVISION);
+
+    // Whole window is the first rectangle (it is split in parallel by subdivide)
+    this -> subdivide(0, width, 0, height);
+
+    // Filled points are not iterated, so continuing only the saved orbits on increasing precision would leave them
+    // with the old iteration count of their rectangle, hence the Set is always rendered again instead
+    have_orbits = false;
+    orbits.clear();
+
+    // Point at (i,j) colored with iteration (mod p) element of the color palette
+    coloring = ESCAPE_COLORING;
+    this -> recolor();
+    this -> save_rendering(addToStack);
+}
+
+// Iterating the center of the view c = cx + icy with big numbers (same recurrence as the optimized algorithm)
+int MandelbrotSet::reference_orbit(vector<double>& zx, vector<double>& zy) {
+    int limbs = center_x.precision();
+    big_number x(limbs);
+    big_number y(limbs);
+    // Orbit starts at z = 0
+    zx.assign(1, 0);
+    zy.assign(1, 0);
+
+    int iteration = 0;
+    while(iteration < max_iteration && !cancel_requested) {
+        big_number x2 = x * x;
+        big_number y2 = y * y;
+        big_number xy = x * y;
+        y = xy + xy + center_y;
+        x = x2 - y2 + center_x;
+        iteration ++;
+
+        // Only doubles are needed by the points (their offsets from this orbit are tiny)
+        double x_d = x.to_double();
+        double y_d = y.to_double();
+        zx.push_back(x_d);
+        zy.push_back(y_d);
+        if(x_d * x_d + y_d * y_d > 4) break;
+    }
+    return iteration;
+}
+
+// Iterating a point c = C + dc (dc = dcx + idcy) as an offset dz from the reference orbit Z of the center,
+// starting after iteration iterations with dz = dx + idy (0 and 0 if it starts from the beginning)
+// Since z = Z + dz, we get dz' = (2Z + dz) dz + dc, which only involves small numbers and so can be done in doubles
+// When |z| gets smaller than |dz|, the offset has lost precision (a "glitch"), and when the reference orbit has escaped
+// it cannot be followed further, so in both cases the orbit is rebased: dz = z, and it continues from the start of the
+// reference orbit (Z = 0)
+static inline int perturbed_orbit(const vector<double>& zx, const vector<double>& zy, int reference_length,
+                                  double dcx, double dcy, double dx, double dy, int iteration, int max_iteration,
+                                  long long& rebases) {
+    // Position in the reference orbit
+    int m = iteration;
+    while(iteration < max_iteration) {
+        double ax = 2 * zx[m] + dx;
+        double ay = 2 * zy[m] + dy;
+        double new_dx = ax * dx - ay * dy + dcx;
+        dy = ax * dy + ay * dx + dcy;
+        dx = new_dx;
+        m ++;
+        iteration ++;
+
+        // Full value of z, which escapes exactly as in the escape time algorithm
+        double x = zx[m] + dx;
+        double y = zy[m] + dy;
+        double r = x * x + y * y;
+        if(r > 4) break;
+
+        if(r < dx * dx + dy * dy || m == reference_length) {
+            dx = x;
+            dy = y;
+            m = 0;
+            rebases ++;
+        }
+    }
+    return iteration;
+}
+
+// Value of the series approximation for the offset u (scaled by delta) of a point from the center
+static inline void series_value(const series_coefficients& s, double ux, double uy, double& dx, double& dy) {
+    // Horner's rule: dz = ((C u + B) u + A) u
+    double x = s.cx * ux - s.cy * uy + s.bx;
+    double y = s.cx * uy + s.cy * ux + s.by;
+    double new_x = x * ux - y * uy + s.ax;
+    y = x * uy + y * ux + s.ay;
+    x = new_x;
+    dx = x * ux - y * uy;
+    dy = x * uy + y * ux;
+}
+
+// Series approximation: while offsets are small, dz after n iterations is a polynomial in dc, whose coefficients
+// follow from dz' = 2Z dz + dz^2 + dc:
+// A' = 2Z A + 1, B' = 2Z B + A^2, C' = 2Z C + 2AB (with A, B, C scaled by delta, delta^2 and delta^3)
+// So all points can skip the iterations where this polynomial (with 3 terms) is still accurate
+int MandelbrotSet::series_start(const vector<double>& zx, const vector<double>& zy, int reference_length, double delta, series_coefficients& series) {
+    // Coefficients after every iteration, so that the series can be cut back if validation fails
+    vector<series_coefficients> steps(1);
+    series_coefficients s = series_coefficients();
+    steps[0] = s;
+
+    for(int n = 0; n + 1 < reference_length && n + 1 < max_iteration; n ++) {
+        double tx = 2 * zx[n];
+        double ty = 2 * zy[n];
+        series_coefficients next;
+        next.ax = tx * s.ax - ty * s.ay + delta;
+        next.ay = tx * s.ay + ty * s.ax;
+        next.bx = tx * s.bx - ty * s.by + (s.ax * s.ax - s.ay * s.ay);
+        next.by = tx * s.by + ty * s.bx + 2 * s.ax * s.ay;
+        double abx = s.ax * s.bx - s.ay * s.by;
+        double aby = s.ax * s.by + s.ay * s.bx;
+        next.cx = tx * s.cx - ty * s.cy + 2 * abx;
+        next.cy = tx * s.cy + ty * s.cx + 2 * aby;
+
+        // Truncation error of the series (about the size of the next term) must be small compared to its first term
+        double a = hypot(next.ax, next.ay);
+        double b = hypot(next.bx, next.by);
+        double c = hypot(next.cx, next.cy);
+        if(c > SERIES_TOLERANCE * a) break;
+        // No point may escape during the skipped iterations (|u| <= 1, so |dz| <= |A| + |B| + |C|)
+        if(hypot(zx[n + 1], zy[n + 1]) + a + b + c > 2) break;
+
+        s = next;
+        steps.push_back(s);
+    }
+
+    // Validating the series at the corners and middles of the edges of the view (the largest offsets), which are
+    // iterated directly (without rebasing) till the iteration where the series would start
+    // If some of them do not agree, then the number of skipped iterations is halved
+    int start = steps.size() - 1;
+    double hx = span_x / 2;
+    double hy = span_y / 2;
+    double probes[8][2] = { {-hx, -hy}, {hx, -hy}, {-hx, hy}, {hx, hy}, {0, -hy}, {0, hy}, {-hx, 0}, {hx, 0} };
+    while(start > 0) {
+        bool valid = true;
+        for(int k = 0; k < 8 && valid; k ++) {
+            double dcx = probes[k][0];
+            double dcy = probes[k][1];
+            double dx = 0;
+            double dy = 0;
+            for(int n = 0; n < start; n ++) {
+                double ax = 2 * zx[n] + dx;
+                double ay = 2 * zy[n] + dy;
+                double new_dx = ax * dx - ay * dy + dcx;
+                dy = ax * dy + ay * dx + dcy;
+                dx = new_dx;
+            }
+            double sx;
+            double sy;
+            series_value(steps[start], dcx / delta, dcy / delta, sx, sy);
+            if(hypot(sx - dx, sy - dy) > SERIES_VALIDATION * hypot(dx, dy)) valid = false;
+        }
+        if(valid) break;
+        start /= 2;
+    }
+
+    series = steps[start];
+    return start;
+}
+
+void MandelbrotSet::perturbationEscapeTime(bool addToStack) {
+    this -> start_rendering(PERTURBATION);
+
+    // Orbit of the center is the only one found in high precision
+    vector<double> zx;
+    vector<double> zy;
+    int reference_length = this -> reference_orbit(zx, zy);
+
+    // Largest offset of a point from the center (at the corners), and the iteration from which all points start
+    double delta = hypot(span_x, span_y) / 2;
+    series_coefficients series = series_coefficients();
+    int start = 0;
+    if(series_approximation) start = this -> series_start(zx, zy, reference_length, delta, series);
+    // (points reused from the previous rendering or found in the tile cache are not iterated)
+    series_skipped = (long long)start * (width * height - reused_points - cached_points);
+
+    render_tiles([&](int i_start, int i_end, int j_start, int j_end) {
+        // Number of rebases in this tile
+        long long tile_rebases = 0;
+        TELEMETRY_COUNTERS(counters);
+
+        for(int j = j_start; j < j_end; j ++) {
+            for(int i = i_start; i < i_end; i ++) {
+                // Points reused from the previous rendering already have their iteration counts
+                if(this -> is_reused(j*width + i)) continue;
+                // Offset of the point (i,j) from the center (same point as lim_l + (lim_r - lim_l) * i / width, etc.)
+                // The interior check and cycle detection are not done, as they need c and z in full precision
+                double dcx = span_x * ((double)i / width - 0.5);
+                double dcy = span_y * ((double)j / height - 0.5);
+                // Offset after the skipped iterations, from the series approximation
+                double dx = 0;
+                double dy = 0;
+                if(start > 0) series_value(series, dcx / delta, dcy / delta, dx, dy);
+                int iteration = perturbed_orbit(zx, zy, reference_length, dcx, dcy, dx, dy, start, max_iteration, tile_rebases);
+                TELEMETRY_POINT(counters, j*width + i, start, iteration, 0, 0);
+                iterations[j*width + i] = iteration;
+                if(period_output) periods[j*width + i] = 0;
+            }
+        }
+        rebases += tile_rebases;
+        TELEMETRY_ADD(counters);
+    });
+
+    // Orbits are not saved (offsets depend on the reference orbit, which changes with max_iteration),
+    // so increasing precision renders the Set again
+    have_orbits = false;
+    orbits.clear();
+
+    // Point at (i,j) colored with iteration (mod p) element of the color palette
+    coloring = ESCAPE_COLORING;
+    this -> recolor();
+    this -> save_rendering(addToStack);
+}
+
+// Points are iterated tile by tile, row by row, with the derivative of z, so every point which escapes has an estimate
+// of its distance from the Set (used to shade it), and a lower bound of this distance
+// The Set is at least that far from the point, so every point of the tile in a disc around it is at least the lower
+// bound minus its distance from the center away from the Set: in the disc where this is at least 4 DISTANCE_SHADE points,
+// points would be white anyway (see DISTANCE_SHADE), so they are filled (with the lower bound of their distance, and the
+// iteration count of the center, which is only close to their own count) and not iterated
+// Distances are measured in the plane, so the disc covers fewer columns than rows if points are further apart along x
+// Discs are not taken beyond their tile, so that no point is written by two threads
+void MandelbrotSet::distanceEstimation(bool addToStack) {
+    this -> start_rendering(DISTANCE);
+    // Distances are found in points (the smaller of the distances between adjacent columns and rows), and steps are the
+    // distances between adjacent columns and rows in points
+    double spacing = min((lim_r - lim_l) / width, (lim_t - lim_b) / height);
+    double step_x = (lim_r - lim_l) / width / spacing;
+    double step_y = (lim_t - lim_b) / height / spacing;
+
+    render_tiles([&](int i_start, int i_end, int j_start, int j_end) {
+        // Number of points of this tile skipped by the interior check, and filled
+        long long skipped = 0;
+        long long tile_filled = 0;
+        TELEMETRY_COUNTERS(counters);
+        // Points of this tile which are done (iterated or filled), at (i - i_start, j - j_start)
+        char done[TILE_SIZE * TILE_SIZE] = {};
+
+        for(int j = j_start; j < j_end; j ++) {
+            for(int i = i_start; i < i_end; i ++) {
+                if(done[(j - j_start) * TILE_SIZE + i - i_start]) continue;
+                done[(j - j_start) * TILE_SIZE + i - i_start] = 1;
+                // Find point (x0,y0) in the limits corresponding to (i,j)
+                double x0 = lim_l + ((lim_r - lim_l) * i) / width;
+                double y0 = lim_b + ((lim_t - lim_b) * j) / height;
+                // Points in the main cardioid or the period-2 bulb never escape, so they are not iterated
+                int interior_period = interior_check ? in_cardioid_or_bulb(x0, y0) : 0;
+                if(interior_period > 0) {
+                    iterations[j*width + i] = max_iteration;
+                    distances[j*width + i] = 0;
+                    if(period_output) periods[j*width + i] = interior_period;
+                    skipped ++;
+                    continue;
+                }
+
+                orbit_state z = orbit_state();
+                double dx = 0;
+                double dy = 0;
+                int period = 0;
+                int iteration = distance_orbit(x0, y0, z, dx, dy, 0, max_iteration, tolerance, period);
+                TELEMETRY_POINT(counters, j*width + i, 0, iteration, period, z.saved_at);
+                iterations[j*width + i] = iteration;
+                if(period_output) periods[j*width + i] = period;
+                // Points which did not escape are taken to be in the Set
+                if(iteration >= max_iteration) {
+                    distances[j*width + i] = 0;
+                    continue;
+                }
+
+                double estimate;
+                double lower;
+                exterior_distance(z.x, z.y, dx, dy, iteration, spacing, estimate, lower);
+                distances[j*width + i] = (float)estimate;
+
+                // Filling the disc of radius lower - 4 DISTANCE_SHADE around (i,j), from row j on (rows above it are done)
+                double radius = lower - 4 * DISTANCE_SHADE;
+                if(!distance_filling || radius < 1) continue;
+                int reach_x = (int)(radius / step_x);
+                int reach_y = (int)(radius / step_y);
+                for(int v = j; v <= min(j + reach_y, j_end - 1); v ++) {
+                    for(int u = max(i - reach_x, i_start); u <= min(i + reach_x, i_end - 1); u ++) {
+                        double offset = sqrt((u - i) * step_x * (u - i) * step_x + (v - j) * step_y * (v - j) * step_y);
+                        if(offset > radius || done[(v - j_start) * TILE_SIZE + u - i_start]) continue;
+                        done[(v - j_start) * TILE_SIZE + u - i_start] = 1;
+                        iterations[v*width + u] = iteration;
+                        distances[v*width + u] = (float)(lower - offset);
+                        if(period_output) periods[v*width + u] = 0;
+                        tile_filled ++;
+                    }
+                }
+            }
+        }
+        interior_skipped += skipped;
+        filled += tile_filled;
+        TELEMETRY_ADD(counters);
+    });
+
+    // Orbits are not saved (continuing them would also need their derivatives), so increasing precision renders the Set again
+    have_orbits = false;
+    // Points are shaded by their distance from the Set
+    coloring = DISTANCE_COLORING;
+    this -> recolor();
+    this -> save_rendering(addToStack);
 }
@@ -1,9 +1,132 @@
 #ifndef __MANDELBROT_H__
 #define __MANDELBROT_H__
 #include <SFML/Graphics.hpp>
+#include <atomic>
+#include <functional>
+#include "bignum.h"
+#include "scalar.h"
+#include "simd.h"
 #include "stack.h"
+#include "telemetry.h"
+#include "threadpool.h"
+#include "tile_cache.h"
 using namespace std;
 
+// Framebuffer is passed to sf::Texture as an array of RGBA8 bytes, so every color must take exactly 4 bytes
+static_assert(sizeof(sf::Color) == 4, "sf::Color must be 4 bytes (RGBA8)");
+
+// Side of the square tiles into which the window is split for parallel rendering
+const int TILE_SIZE = 32;
+
+// Tolerance of cycle detection, as a fraction of the distance between adjacent points of the window
+// Orbits which come back this close to a saved value are taken to be periodic (i.e. inside the Set)
+const double CYCLE_TOLERANCE = 1e-3;
+
+// Rectangles of the subdivision algorithm with a side of at most SUBDIVISION_LEAF points are iterated point by point,
+// and those with a side of more than TILE_SIZE points are split further in parallel
+const int SUBDIVISION_LEAF = 6;
+
+// Below this distance between adjacent points, doubles cannot tell points apart, so AUTO uses the perturbation algorithm
+const double DEEP_ZOOM_SPACING = 1e-13;
+// A scalar type is chosen for a view only if it resolves SCALAR_MARGIN times less than the distance between adjacent points
+// (rounding errors grow over the iterations of an orbit, so resolving exactly one point apart is not enough)
+const double SCALAR_MARGIN = 1024;
+// Smallest distance between adjacent points (offsets from the center are doubles, which cannot go much lower)
+const double MIN_SPACING = 1e-290;
+// Series approximation is used only while its third term is below SERIES_TOLERANCE times its first term, and only if
+// it agrees with directly iterated probe points within SERIES_VALIDATION (relative error)
+const double SERIES_TOLERANCE = 1e-9;
+const double SERIES_VALIDATION = 1e-6;
+// Escape radius of continuous coloring, squared (a large radius makes the smooth iteration count accurate), and the
+// number of colors of the interpolated palette between two colors of the palette (continuous coloring picks the one at
+// the fractional part of the iteration count of a point, rounded down to a step)
+const double SMOOTH_BAILOUT = 65536;
+const int PALETTE_STEPS = 16;
+// Points outside the Set are shaded by distance estimation from the color of the Set, at its boundary, to white, at
+// DISTANCE_SHADE points from it or more
+// The estimated distance is at least 1/4 of the true distance, so points whose distance is known to be at least
+// 4 DISTANCE_SHADE points are white anyway, and they are filled instead of iterated
+const double DISTANCE_SHADE = 2;
+// Number of passes of a progressive rendering: points on every 4th row and column (1/16 of the points), then on every
+// 2nd row and column (1/4), then on a checkerboard (1/2), then all points (each point is iterated in exactly one pass)
+const int PROGRESSIVE_PASSES = 4;
+
+// Points of a new view within this distance (as a fraction of the distance between adjacent points) of a point of the
+// previous rendering reuse its iteration count (when reprojection is enabled)
+const double REPROJECTION_TOLERANCE = 0.1;
+
+// Number of points along each axis of the probe from which the scheduler predicts the iterations of a rendering (see
+// MandelbrotSet::set_time_budget), and the cost of a point besides its iterations (coloring, buffers), in iterations
+const int PROBE_SIZE = 24;
+const double POINT_COST = 20;
+
+// Rendering algorithms which can be selected for the Set
+// AUTO chooses an algorithm based on the precision (see MandelbrotSet::Algorithm)
+enum algorithm_type { AUTO, UNOPTIMIZED, OPTIMIZED, PERIODIC, CONTINUOUS, HISTOGRAM, VECTORIZED, SUBDIVISION, PERTURBATION, DISTANCE };
+
+// Function to return the name of an algorithm (used on the command line and in benchmark results)
+const char* algorithm_name(algorithm_type algorithm);
+
+// Ways of mapping the iteration buffers of a rendering to the color palette
+// ESCAPE_COLORING uses the iteration count, CONTINUOUS_COLORING also uses its fractional part,
+// HISTOGRAM_COLORING uses the number of points having a smaller or equal iteration count, and DISTANCE_COLORING uses
+// the distance of the point from the Set (found by distance estimation)
+enum coloring_type { ESCAPE_COLORING, CONTINUOUS_COLORING, HISTOGRAM_COLORING, DISTANCE_COLORING };
+
+// State of the orbit of a point (i,j) which did not escape in a rendering, so that it can be continued later
+struct orbit_state {
+    // Point of the window to which the orbit belongs
+    int i;
+    int j;
+    // Last value of z = x + iy
+    double x;
+    double y;
+    // Value of z saved for cycle detection, and the iteration (a power of 2) at which it was saved
+    double xold;
+    double yold;
+    int saved_at;
+};
+
+// Coefficients of the series approximation of the offset of a point from the reference orbit after some iterations
+// dz = A u + B u^2 + C u^3 (complex), where u = dc / delta is the offset of c from the center, scaled by the largest
+// offset delta (so that the coefficients do not underflow in deep zooms)
+struct series_coefficients {
+    double ax;
+    double ay;
+    double bx;
+    double by;
+    double cx;
+    double cy;
+};
+
+// Iterations of a rendering of the whole view without and with cycle detection, predicted by the scheduler from a probe
+// of PROBE_SIZE x PROBE_SIZE points
+struct render_probe {
+    double iterations;
+    double periodic_iterations;
+};
+
+// Last rendering before the view was changed (by zooming in, panning or setting the view), kept so that the next
+// rendering can reuse the points which it shares with it
+struct previous_rendering {
+    // View of the rendering
+    big_number center_x;
+    big_number center_y;
+    double span_x;
+    double span_y;
+    // Precision, algorithm and scalar type of the rendering (its iteration counts are reused only if all of them are the same)
+    int max_iteration;
+    algorithm_type algorithm;
+    scalar_type scalar;
+    // Iteration buffers, colors and saved orbits of the rendering (same layout as those of the Set)
+    vector<int> iterations;
+    vector<float> fractions;
+    vector<int> periods;
+    vector<sf::Color> colors;
+    vector<orbit_state> orbits;
+    bool have_orbits;
+};
+
 // Class containing methods to render Mandelbrot Set using various algorithms, and at different zooms and precisions
 class MandelbrotSet {
 
@@ -26,43 +149,352 @@ private:
     double lim_b;
     // Zoom factor of the given rendering
     long long zoom;
+    // Center of the view in high precision, and its width and height (limits are found from these)
+    big_number center_x;
+    big_number center_y;
+    double span_x;
+    double span_y;
     // Color palette used for the coloring of the Set (uses p as a random input)
     vector<sf::Color> palette;
-    // Array of points in the window, having information about their color
-    sf::VertexArray points;
+    // Interpolated palette used by continuous coloring: PALETTE_STEPS colors from every color of the palette towards
+    // the next one (p * PALETTE_STEPS colors, found whenever the palette changes)
+    vector<sf::Color> smooth_palette;
+    // Colors of all points in the window as RGBA8, stored row by row (so that it can be copied to an sf::Texture as it is)
+    vector<sf::Color> framebuffer;
+    // Whether the framebuffer has changed since it was last shown
+    bool dirty;
+    // Iteration count of every point in the last rendering, stored row by row like the framebuffer (point (i,j) at index j*width + i)
+    vector<int> iterations;
+    // Fractional part of the iteration count of every point (used only by continuous coloring)
+    vector<float> fractions;
+    // Distance of every point from the Set, in points (found by distance estimation; 0 for points of the Set)
+    vector<float> distances;
+    // Coloring used by the last rendering
+    coloring_type coloring;
+    // Histogram of iteration counts used by histogram coloring instead of the one of the rendering, if not empty (set when
+    // a large image is rendered in strips, so that all strips are colored alike)
+    vector<long long> shared_histogram;
+    // Whether the iteration buffers belong to the plot in the framebuffer (false after zooming out)
+    bool have_iterations;
+    // Max number of iterations with which the iteration buffers were found
+    int rendered_max_iteration;
+    // Orbits of all points which did not escape in the last rendering
+    vector<orbit_state> orbits;
+    // Mutex used while adding orbits from different threads
+    mutex orbits_lock;
+    // Algorithm used by the last rendering (which found these orbits)
+    algorithm_type orbits_algorithm;
+    // Whether the orbits belong to the plot in the framebuffer (false after zooming out)
+    bool have_orbits;
     // Stack containing rendering of the Mandelbrot Set at different zoom levels
     stack_pixels st;
+    // Pool of threads on which the tiles of a rendering are computed
+    thread_pool pool;
+    // Algorithm used for rendering (AUTO by default)
+    algorithm_type algorithm;
+    // Instruction set used by the vectorized escape time algorithm (best one supported by the processor by default)
+    simd_level simd;
+    // Scalar type used by the optimized, periodic, histogram and vectorized algorithms (AUTO by default),
+    // and the type used by the last rendering (whose orbits can be continued only in the same type)
+    scalar_type scalar;
+    scalar_type last_scalar;
+    // Whether points in the main cardioid or the period-2 bulb are found by a direct check instead of iterating them
+    bool interior_check;
+    // Number of points found by this check in the last rendering (updated by all threads)
+    atomic<long long> interior_skipped;
+    // Whether all algorithms use cycle detection (the periodic algorithm always uses it)
+    bool cycle_detection;
+    // Tolerance of cycle detection in the last rendering (0 if it did not use cycle detection)
+    double tolerance;
+    // Whether the period found for every point is saved, and the periods of the last rendering
+    // (0 for points which escaped or were not found to be periodic, same indices as iterations)
+    bool period_output;
+    vector<int> periods;
+    // Number of points filled (instead of iterated) by the subdivision algorithm or distance estimation in the last rendering
+    atomic<long long> filled;
+    // Whether distance estimation fills the points known to be far enough outside the Set
+    bool distance_filling;
+    // Number of times the perturbation algorithm moved orbits back to the start of the reference orbit in the last rendering
+    atomic<long long> rebases;
+    // Whether the perturbation algorithm starts all points with the series approximation
+    bool series_approximation;
+    // Number of iterations skipped by the series approximation in the last rendering (for all points together)
+    long long series_skipped;
+    // Telemetry of the last rendering (only kept when MANDELBROT_TELEMETRY is defined)
+    render_telemetry telemetry;
+    // Whether the rendering in progress must stop (set from other threads, checked before every tile)
+    atomic<bool> cancel_requested;
+    // Number of points done in the rendering in progress, out of work_total (read from other threads)
+    atomic<long long> work_done;
+    atomic<long long> work_total;
+    // Whether the optimized, periodic and histogram algorithms render progressively, and the function called (on the
+    // rendering thread) when the preview after each pass but the last is in the framebuffer
+    bool progressive;
+    function<void()> preview_listener;
+    // Whether renderings reuse the points of the previous rendering, and the tolerance for reusing them
+    bool reprojection;
+    double reprojection_tolerance;
+    // Previous rendering (if any), and for every point of the rendering in progress the index of the point of the
+    // previous rendering whose iteration count it reuses (its own index if it was found in the tile cache, and -1 for
+    // points which are iterated)
+    bool have_previous;
+    previous_rendering previous;
+    vector<int> reuse_source;
+    // Whether the rendering in progress reuses points, and whether it has shown a preview from the previous rendering
+    bool reusing;
+    bool reprojected;
+    // Number of points which reused the iteration count of the previous rendering in the last rendering
+    long long reused_points;
+    // Number of points which were found in the tile cache (and not reused from the previous rendering) in the last rendering
+    long long cached_points;
+    // Cache of the tiles of earlier renderings, and whether it is used
+    tile_cache cache;
+    bool cache_enabled;
+    // Whether the rendering in progress uses the cache, and the key of its tiles (the origin is set for every tile)
+    bool caching;
+    tile_key cache_key;
+    // Position of every column and row of the window in its tile of the cache (in cells), first column and row of every
+    // tile of the cache covering the window (followed by width and height), and hash of the origin of every such tile
+    // along x and y
+    vector<double> cache_column_position;
+    vector<double> cache_row_position;
+    vector<int> cache_columns;
+    vector<int> cache_rows;
+    vector<unsigned long long> cache_column_origins;
+    vector<unsigned long long> cache_row_origins;
+    // Time budget of renderings with the AUTO algorithm (in seconds, 0 if there is none)
+    double time_budget;
+    // Cost model of the scheduler: time of an iteration of every algorithm in every scalar type on one thread (in
+    // seconds), updated by every rendering it times
+    double iteration_seconds[DISTANCE + 1][SCALAR_FIXED128 + 1];
+    // Algorithm of the quick frame of the last scheduled rendering (AUTO if it had none), and the predicted time of its
+    // final algorithm (in seconds)
+    algorithm_type quick_algorithm;
+    double predicted_time;
+
+    // Function to render the window tile by tile in parallel
+    // render_tile(i_start, i_end, j_start, j_end) must render the points (i,j) with i in [i_start, i_end) and j in [j_start, j_end)
+    void render_tiles(const function<void(int, int, int, int)>& render_tile);
+    // Function to push the current rendering to the stack (if addToStack is true)
+    void save_rendering(bool addToStack);
+    // Function to color points using the iteration buffers and the palette (without iterating again)
+    void recolor();
+    // Function to find the interpolated palette from the palette
+    void interpolate_palette();
+    // Function to find the algorithm to be used by Algorithm() (resolves AUTO based on precision)
+    algorithm_type chosen_algorithm();
+    // Function to call an algorithm (not AUTO)
+    void run_algorithm(algorithm_type algorithm, bool addToStack);
+    // Functions used by the scheduler: to iterate a probe of the view, to find the work of an algorithm predicted by the
+    // probe (iterations and the cost of all points, in iterations) and its predicted time, to run an algorithm timing it
+    // (to update the cost model), and to render the algorithm chosen by AUTO within the time budget
+    render_probe probe();
+    double probe_work(algorithm_type algorithm, const render_probe& probe);
+    double predicted_seconds(algorithm_type algorithm, const render_probe& probe);
+    void timed_algorithm(algorithm_type algorithm, bool addToStack, const render_probe& probe);
+    void scheduled_algorithm(algorithm_type algorithm, bool addToStack);
+    // Function to find the scalar type to be used by an algorithm in the current view (resolves SCALAR_AUTO based on
+    // the distance between adjacent points; algorithms which are not templated always use doubles)
+    scalar_type chosen_scalar(algorithm_type algorithm);
+    // Functions to render all points with the optimized escape time iteration in the chosen scalar type (used by the
+    // optimized, periodic and histogram algorithms), and in a given scalar type T (interior is whether the interior
+    // check can be done, as it uses doubles, and pass is the pass of a progressive rendering whose points are rendered,
+    // or -1 for all points)
+    void scalar_render(algorithm_type algorithm);
+    template<typename T> void scalar_tiles(bool interior, int pass);
+    // Function to color the preview after a pass of a progressive rendering (points which are not iterated yet take the
+    // color of a nearby point which is) and pass it to the preview listener
+    void show_preview(int pass, coloring_type preview_coloring);
+    // Functions to clear the saved orbits and counters at the start of a rendering, and to save the orbits of a tile
+    void start_rendering(algorithm_type algorithm);
+    // Function to keep the current rendering as the previous rendering before the view is changed
+    void save_previous();
+    // Function to map the previous rendering to the view of a new rendering: every point is shown with the color of the
+    // nearest point of the previous rendering, and reuses its iteration count if it is within the tolerance (and the
+    // algorithm iterates points in the same way)
+    void reproject(algorithm_type algorithm);
+    // Function to check whether point k (index j*width + i) reused its iteration count from the previous rendering
+    // or from the tile cache
+    bool is_reused(int k);
+    // Function to place the points of the view on the grid of the tile cache, for a rendering with an algorithm
+    void cache_grid(algorithm_type algorithm);
+    // Function to return the key of the tile of the cache in column a and row b of the tiles covering the window
+    tile_key cache_tile_key(int a, int b);
+    // Functions to fill the points of a new rendering which are found in the tile cache (they are not iterated again by
+    // the algorithms which reuse points), and to add the points it iterated to the cache once the rendering is finished
+    void fill_from_cache(algorithm_type algorithm);
+    void store_in_cache();
+    void save_orbits(vector<orbit_state>& tile_orbits);
+    // Function to find the tolerance of cycle detection for an algorithm in the current limits (0 if not used)
+    double cycle_tolerance(algorithm_type algorithm);
+    // Functions used by the subdivision algorithm, to iterate a single point (saving its orbit in rect_orbits if it
+    // does not escape) and to render the rectangle of points (i,j) with i in [i_start, i_end) and j in [j_start, j_end)
+    int subdivision_point(int i, int j, vector<orbit_state>& rect_orbits);
+    void subdivide(int i_start, int i_end, int j_start, int j_end);
+    // Function to find the limits from the center and size of the view
+    void update_limits();
+    // Function to iterate the center of the view with big numbers, saving its orbit (as doubles) in zx, zy
+    // Returns the number of iterations done (till the orbit escapes, or max_iteration)
+    int reference_orbit(vector<double>& zx, vector<double>& zy);
+    // Function to find the iteration from which all points can start, and the series coefficients at that iteration
+    // (delta is the largest offset of a point from the center)
+    int series_start(const vector<double>& zx, const vector<double>& zy, int reference_length, double delta, series_coefficients& series);
+    // Function to continue the saved orbits from old_max_iteration till max_iteration (after precision is increased)
+    void resume_orbits(int old_max_iteration);
 
 public:
     // Constructor (takes member variables p, width, height, max_iteration as input)
     MandelbrotSet(int p, int width, int height, int q, int r, int s, int max_iteration);
     // Function to change color palette
     void change_colors(int p, int q, int r, int s);
-    // Function to return array points
-    sf::VertexArray get_points();
+    // Function to return the framebuffer (width * height RGBA8 colors, row by row)
+    const sf::Uint8* get_pixels();
+    // Functions to check whether the framebuffer changed since it was last shown, and to mark it as shown
+    bool is_dirty();
+    void clear_dirty();
     // Function to return zoom
     long long get_zoom();
     // Function to return precision (i.e. max_iteration)
     int get_precision();
+    // Functions to set and return the number of threads used for rendering (threads <= 0 means one per core)
+    void set_threads(int threads);
+    int get_threads();
+    // Functions to return the number of renderings saved in the stack, and the memory used by them (in bytes)
+    int get_stack_size();
+    size_t get_stack_bytes();
+    // Function to set the memory (in bytes) which can be used by the saved renderings (oldest ones are evicted first)
+    void set_stack_budget(size_t bytes);
+    // Function to enable or disable the interior check (points in the main cardioid or period-2 bulb are not iterated)
+    void set_interior_check(bool interior_check);
+    // Function to return number of points skipped by the interior check in the last rendering
+    long long get_interior_skipped();
+    // Function to set the view by its center (in high precision) and its width and height
+    void set_view(const big_number& x, const big_number& y, double span_x, double span_y);
+    // Functions to return the center of the view, and its width and height
+    const big_number& get_center_x();
+    const big_number& get_center_y();
+    double get_span();
+    double get_span_y();
+    // Function to return number of rebases done by the perturbation algorithm in the last rendering
+    long long get_rebases();
+    // Function to enable or disable the series approximation in the perturbation algorithm, and to return the number
+    // of iterations it skipped in the last rendering
+    void set_series_approximation(bool series_approximation);
+    long long get_series_skipped();
+    // Function to return the fraction of points filled (instead of iterated) by the subdivision algorithm or distance
+    // estimation in the last rendering
+    double get_filled_fraction();
+    // Function to enable or disable the filling of points known to be far enough outside the Set by distance estimation
+    // (it does not change the plot, only which points are iterated)
+    void set_distance_filling(bool distance_filling);
+    // Function to return the distance of every point from the Set in the last rendering with distance estimation (in
+    // points, width * height values, row by row; points which were filled have a lower bound of their distance)
+    const vector<float>& get_distances();
+    // Function to enable or disable cycle detection in all algorithms (it is always used by the periodic algorithm)
+    void set_cycle_detection(bool cycle_detection);
+    // Function to enable or disable saving of the period found for every point, and to return these periods
+    // (width * height values, same indices as the iteration counts)
+    void set_period_output(bool period_output);
+    const vector<int>& get_periods();
+    // Function to return the iteration counts of the last rendering (width * height values, row by row), and its coloring
+    // Points filled by distance estimation have the count of the point they were filled from, which is only close to their
+    // own (the plot is the same, but not the counts in the heatmap, the histogram or after a change of coloring)
+    const vector<int>& get_iterations();
+    coloring_type get_coloring();
+    // Function to set the histogram used by histogram coloring (number of points of the whole image having each iteration
+    // count, from 0 to max_iteration), for an image rendered in parts; an empty histogram uses the rendering's own
+    void set_shared_histogram(const vector<long long>& histogram);
+    // Functions to set and return the algorithm used by Algorithm()
+    void set_algorithm(algorithm_type algorithm);
+    algorithm_type get_algorithm();
+    // Functions to set and return the instruction set used by the vectorized escape time algorithm
+    void set_simd_level(simd_level simd);
+    simd_level get_simd_level();
+    // Functions to set and return the scalar type used by the optimized, periodic, histogram and vectorized algorithms,
+    // and to return the type used by the last rendering (never SCALAR_AUTO)
+    void set_scalar_type(scalar_type scalar);
+    scalar_type get_scalar_type();
+    scalar_type get_last_scalar();
+    // Functions to stop the rendering in progress (can be called from any thread), to allow renderings again, and to check
+    // whether the last rendering was stopped
+    // A stopped rendering leaves the framebuffer unfinished (and not dirty), and is pushed to the stack without colors
+    // (so it is rendered again when it is reached by zooming out)
+    void request_cancel();
+    void clear_cancel();
+    bool is_cancelled();
+    // Function to return the fraction of points done by the rendering in progress (can be called from any thread)
+    double get_progress();
+    // Functions to enable or disable progressive rendering of the optimized, periodic and histogram algorithms, and to set
+    // the function called with each preview (it may read the framebuffer, but must not change the Set)
+    void set_progressive(bool progressive);
+    bool get_progressive();
+    void set_preview_listener(const function<void()>& preview_listener);
+    // Functions to set the time budget of renderings with the AUTO algorithm (in seconds, 0 for none), and to return how the
+    // last one was scheduled: the algorithm of its quick frame (AUTO if it had none), and the predicted time of its
+    // final algorithm (in seconds)
+    // With a budget, a probe of the view predicts the time of the algorithm chosen by AUTO; if it fits, it is rendered
+    // without previews; if not, the fastest algorithm is rendered first and shown as a preview (progressively, at
+    // reduced resolution, if even it does not fit), and the chosen algorithm then refines it
+    void set_time_budget(double seconds);
+    algorithm_type get_quick_algorithm();
+    double get_predicted_seconds();
+    // Functions to enable or disable the reuse of the previous rendering after a change of view (for previews, and for the
+    // iteration counts of points within tolerance of its points, as a fraction of the distance between adjacent points),
+    // and to return the fraction of points whose iteration count was reused in the last rendering
+    // The optimized, periodic, histogram, continuous, vectorized and perturbation algorithms reuse iteration counts
+    void set_reprojection(bool reprojection);
+    void set_reprojection_tolerance(double reprojection_tolerance);
+    double get_reused_fraction();
+    // Functions to set the memory (in bytes) which can be used by the tile cache (0 disables it), to return the memory used
+    // by it, and to return the number of points found and not found in it
+    void set_cache_budget(size_t bytes);
+    size_t get_cache_bytes();
+    long long get_cache_hits();
+    long long get_cache_misses();
+    // Function to return the telemetry of the last rendering (iterations, how points ended, time of every phase and tile)
+    // Only the counters kept anyway are set unless MANDELBROT_TELEMETRY is defined
+    telemetry_report get_telemetry();
+    // Functions to find a heatmap of the iterations done by every point of the last rendering (width * height colors,
+    // row by row, see heatmap_colors; without telemetry the iteration counts are used), and to write it to a PPM or PNG
+    // image (returns false if it cannot be written)
+    void get_heatmap(vector<sf::Color>& colors);
+    bool write_heatmap(const string& path);
     // Functions to increase and decrease precision (value changed by 100)
     void inc_precision();
     void dec_precision();
-    // Function to call different rendering Algorithms based on precision involved
+    // Function to call the selected rendering algorithm (or one based on precision involved, if it is AUTO, scheduled
+    // within the time budget if there is one)
     // If addToStack is true, then the new rendering is pushed to the stack
     void Algorithm(bool addToStack);
     // Function to find the new values of limits of the Set on zooming in at point (x,y)
     void zoom_in(double x, double y);
+    // Function to move the view by dx points to the right and dy points down (in the same direction as the points of the
+    // window), at the same zoom
+    // The rendering of the view before panning is removed from the stack, so the next rendering should be pushed to the stack
+    void pan(int dx, int dy);
     // Function to show the last zoomed out rendering
     void zoom_out();
     // Plotting Mandelbrot Set with Escape Time Algorithm (Unoptimized)
     void unoptimizedEscapeTime(bool addToStack);
     // Plotting Mandelbrot Set with Escape Time Algorithm (Optimized)
     void optimizedEscapeTime(bool addToStack);
-    // Plotting Mandelbrot Set with Escape Time Algorithm, and reducing time by checking periodicity (Optimized)
+    // Plotting Mandelbrot Set with Escape Time Algorithm, and reducing time by detecting cycles of orbits (Optimized)
     void periodicallyCheckedEscapeTime(bool addToStack);
     // Plotting Mandelbrot Set using Histogram Coloring (involves optimized escape time algorithm as a subtask)
     void histogramColoring(bool addToStack);
     // Plotting Mandelbrot Set using Continuous (smooth) Coloring
     void continuousColoring(bool addToStack);
+    // Plotting Mandelbrot Set with Escape Time Algorithm (Optimized), iterating several adjacent points at once with vector instructions
+    void vectorizedEscapeTime(bool addToStack);
+    // Plotting Mandelbrot Set with Escape Time Algorithm (Optimized), filling rectangles whose border has a single
+    // iteration count (Mariani-Silver subdivision)
+    void subdivisionEscapeTime(bool addToStack);
+    // Plotting Mandelbrot Set in deep zooms using perturbation: only the center is iterated in high precision,
+    // and all points are iterated as (double) offsets from its orbit
+    void perturbationEscapeTime(bool addToStack);
+    // Plotting Mandelbrot Set with distance estimation: the derivative of z is iterated along with it, giving the distance
+    // of every point which escapes from the Set, so that thin filaments are shaded even where no point is in the Set,
+    // and discs of points far enough outside the Set are filled without iterating them
+    void distanceEstimation(bool addToStack);
 };
 #endif // __MANDELBROT_H__
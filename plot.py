@@ -1,35 +1,62 @@
+import csv
 import matplotlib.pyplot as plt
 
-# File containing runtimes of different algorithms
-file = open("runtimes.txt", 'r')
-unoptimized = []
-optimized = []
-periodic = []
-continuous = []
-histogram = []
-# Experiment has been done N (=10) times
-N = 10
-iteration = list(range(1, N + 1))
+# File containing runtimes of different algorithms (written by runtimeCalculator or the benchmark program)
+# Each line has the times of one view, algorithm, number of threads and max number of iterations; columns are found
+# by their names in the header, so columns can be added without changing this script
+file = open("runtimes.csv", 'r')
+rows = list(csv.DictReader(file))
+file.close()
 
-# Making list of runtimes for the 5 algorithms
-for line in file:
-	if line == "":
-		continue
-	line = line.split(" ")
-	unoptimized.append(float(line[0]))
-	optimized.append(float(line[1]))
-	periodic.append(float(line[2]))
-	continuous.append(float(line[3]))
-	histogram.append(float(line[4]))
+viewports = []
+kernels = []
+for row in rows:
+	if row["viewport"] not in viewports:
+		viewports.append(row["viewport"])
+	if row["kernel"] not in kernels:
+		kernels.append(row["kernel"])
+most_threads = max(int(row["threads"]) for row in rows)
 
-# Plotting line charts to compare the 5 alghorithms
-plt.plot(iteration, unoptimized, label = "Unoptimized Escape Time")
-plt.plot(iteration, optimized, label = "Optimized Escape Time")
-plt.plot(iteration, periodic, label = "Periodically Checked Optimized Escape Time")
-plt.plot(iteration, continuous, label = "Continuous Coloring")
-plt.plot(iteration, histogram, label = "Histogram Coloring")
+# Plotting the median runtime of every algorithm on every view (with most threads), with the 10th and 90th percentiles
+# as error bars (time axis is logarithmic, as views differ by orders of magnitude)
+plt.figure(figsize = (12, 6))
+width = 0.8 / len(kernels)
+for k in range(len(kernels)):
+	positions = []
+	medians = []
+	errors = [[], []]
+	for v in range(len(viewports)):
+		for row in rows:
+			if row["viewport"] == viewports[v] and row["kernel"] == kernels[k] and int(row["threads"]) == most_threads:
+				median = float(row["median"])
+				positions.append(v + (k - len(kernels) / 2.0 + 0.5) * width)
+				medians.append(median)
+				errors[0].append(median - float(row["p10"]))
+				errors[1].append(float(row["p90"]) - median)
+				break
+	plt.bar(positions, medians, width, yerr = errors, label = kernels[k])
+plt.xticks(range(len(viewports)), viewports)
+plt.yscale("log")
 plt.legend()
-plt.xlabel("Iteration")
-plt.ylabel("Time (in seconds)")
-plt.title("Runtimes for various Mandelbrot Algorithms")
-plt.savefig("runtime.png")
\ No newline at end of file
+plt.xlabel("View")
+plt.ylabel("Median time (in seconds)")
+plt.title("Runtimes for various Mandelbrot Algorithms (" + str(most_threads) + " threads)")
+plt.savefig("runtime.png")
+
+# Plotting speedup (median runtime with 1 thread / median runtime with t threads) of every algorithm on the first view
+threads = sorted(set(int(row["threads"]) for row in rows))
+if len(threads) > 1:
+	plt.figure()
+	for kernel in kernels:
+		times = {}
+		for row in rows:
+			if row["viewport"] == viewports[0] and row["kernel"] == kernel:
+				times[int(row["threads"])] = float(row["median"])
+		if threads[0] in times:
+			counts = sorted(times)
+			plt.plot(counts, [times[threads[0]] / times[t] for t in counts], marker = "o", label = kernel)
+	plt.legend()
+	plt.xlabel("Threads")
+	plt.ylabel("Speedup")
+	plt.title("Scaling of Mandelbrot Algorithms with number of threads")
+	plt.savefig("scaling.png")
@@ -0,0 +1,192 @@
+#include "mandelbrot.h"
+#include "image_writer.h"
+#include "bignum.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Headless renderer: renders one view of the Mandelbrot Set to a PPM or PNG image, without a window
+// It is a separate program from the window (main.cpp), built from all files except main.cpp
+// The image is rendered in strips of rows, each by the parallel tile engine of a Set as wide as the image and as high as a
+// strip, and every strip is written to the file as soon as it is done, so the memory used does not depend on the height
+// of the image and posters of 32768 x 32768 points or more can be rendered
+
+// Function to print how the program is used
+static void usage(const char* program) {
+    cerr << "Usage: " << program << " [options] output.ppm|output.png\n"
+         << "  --center-x X     real part of the center of the view (decimal, any number of digits; default -0.765)\n"
+         << "  --center-y Y     imaginary part of the center of the view (default 0)\n"
+         << "  --span S         width of the view (default 3.3; the height follows from the size of the image)\n"
+         << "  --size WxH       size of the image in points (default 1920x1080)\n"
+         << "  --kernel NAME    auto, unoptimized, optimized, periodic, continuous, histogram, vectorized,\n"
+         << "                   subdivision, perturbation or distance (default auto)\n"
+         << "  --iterations N   max number of iterations (default 1000)\n"
+         << "  --seed N         seed of the random color palette (default 0)\n"
+         << "  --strip N        rows rendered at a time (default 64)\n"
+         << "  --threads N      threads of the tile engine (default one per core)\n"
+         << "  --heatmap PATH   also write the iterations done by every point as an image (see telemetry.h)\n";
+}
+
+int main(int argc, char** argv) {
+    string center_x = "-0.765";
+    string center_y = "0";
+    double span = 3.3;
+    int width = 1920;
+    int height = 1080;
+    algorithm_type algorithm = AUTO;
+    int max_iteration = 1000;
+    unsigned int seed = 0;
+    int strip = 64;
+    int threads = 0;
+    string output;
+    string heatmap;
+
+    // Reading the options
+    for(int k = 1; k < argc; k ++) {
+        string option = argv[k];
+        if(option.size() > 2 && option.compare(0, 2, "--") == 0) {
+            if(k + 1 >= argc) {
+                cerr << "Missing value of " << option << "\n";
+                return 1;
+            }
+            string value = argv[++ k];
+            if(option == "--center-x") center_x = value;
+            else if(option == "--center-y") center_y = value;
+            else if(option == "--span") span = atof(value.c_str());
+            else if(option == "--size") {
+                if(sscanf(value.c_str(), "%dx%d", &width, &height) != 2) width = 0;
+            }
+            else if(option == "--kernel") {
+                int found = -1;
+                for(int a = 0; a <= DISTANCE; a ++) {
+                    if(value == algorithm_name((algorithm_type)a)) found = a;
+                }
+                if(found < 0) {
+                    cerr << "Unknown kernel " << value << "\n";
+                    return 1;
+                }
+                algorithm = (algorithm_type)found;
+            }
+            else if(option == "--iterations") max_iteration = atoi(value.c_str());
+            else if(option == "--seed") seed = strtoul(value.c_str(), NULL, 10);
+            else if(option == "--strip") strip = atoi(value.c_str());
+            else if(option == "--threads") threads = atoi(value.c_str());
+            else if(option == "--heatmap") heatmap = value;
+            else {
+                cerr << "Unknown option " << option << "\n";
+                usage(argv[0]);
+                return 1;
+            }
+        }
+        else output = option;
+    }
+    if(output.empty() || width <= 0 || height <= 0 || span <= 0 || max_iteration <= 0 || strip <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    strip = min(strip, height);
+    // A strip must hold width * strip points in an int
+    if((long long)width * strip > 1 << 30) {
+        cerr << "Image is too wide for strips of " << strip << " rows\n";
+        return 1;
+    }
+
+    // Color palette made from the seed in the same way as by the window
+    srand(seed);
+    int p = 499 + rand() % 501;
+    int q = 2 + rand() % 998;
+    int r = 2 + rand() % 998;
+    int s = 2 + rand() % 998;
+
+    // Output files are opened before the Set is made, so nothing is left to free if they cannot be written
+    image_writer writer;
+    if(!writer.open(output, width, height)) {
+        cerr << "Cannot write " << output << "\n";
+        return 1;
+    }
+    // Heatmap written strip by strip along with the image
+    image_writer heatmap_writer;
+    vector<sf::Color> heatmap_colors;
+    if(!heatmap.empty() && !heatmap_writer.open(heatmap, width, height)) {
+        cerr << "Cannot write " << heatmap << "\n";
+        return 1;
+    }
+
+    // Set rendering one strip at a time
+    // Renderings are not pushed to the stack or cached, since every strip is rendered once
+    MandelbrotSet* m = new MandelbrotSet(p, width, strip, q, r, s, max_iteration);
+    if(threads > 0) m -> set_threads(threads);
+    m -> set_algorithm(algorithm);
+    m -> set_cache_budget(0);
+    m -> set_stack_budget(0);
+
+    // View of the whole image: points have the same spacing along both axes
+    double span_y = span * height / width;
+    int limbs = max(limbs_for_spacing(span / width), (int)(max(center_x.size(), center_y.size()) * 3.33 / 32) + 2);
+    big_number x(center_x, limbs);
+    big_number y(center_y, limbs);
+
+    auto start = chrono::steady_clock::now();
+    // Histogram coloring needs the histogram of the whole image, so it is rendered twice: the first pass only counts the
+    // iteration counts of every strip, and the second one colors the strips with them
+    // Whether the coloring is histogram coloring is known after the first strip (AUTO may choose it), so the first pass
+    // writes the image directly for all other colorings
+    vector<long long> histogram;
+    bool histogram_pass = false;
+    long long points = 0;
+    for(int pass = 0; pass < 2; pass ++) {
+        if(pass == 1) {
+            if(!histogram_pass) break;
+            m -> set_shared_histogram(histogram);
+        }
+        for(int row = 0; row < height; row += strip) {
+            // Strip of rows row to row + strip - 1 of the image (the last one may extend below the image, and its extra
+            // rows are dropped), with its points on the same grid as the whole image
+            double offset_y = span_y * ((row + strip / 2.0) / height - 0.5);
+            m -> set_view(x, y + big_number(offset_y, limbs), span, span_y * strip / height);
+            m -> Algorithm(false);
+            int rows = min(strip, height - row);
+            points += (long long)width * rows;
+
+            if(pass == 0 && row == 0) histogram_pass = m -> get_coloring() == HISTOGRAM_COLORING;
+            if(pass == 0 && histogram_pass) {
+                const vector<int>& iterations = m -> get_iterations();
+                histogram.resize(max_iteration + 1, 0);
+                for(long long k = 0; k < (long long)width * rows; k ++) {
+                    histogram[min(iterations[k], max_iteration)] ++;
+                }
+            }
+            else {
+                writer.write_rows((const sf::Color*)m -> get_pixels(), rows);
+                if(!heatmap.empty()) {
+                    m -> get_heatmap(heatmap_colors);
+                    heatmap_writer.write_rows(&heatmap_colors[0], rows);
+                }
+            }
+
+            // Progress, with the number of points rendered per second so far
+            double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+            cerr << "\r" << (histogram_pass ? (pass == 0 ? "Counting " : "Coloring ") : "Rendering ")
+                 << min(row + strip, height) << "/" << height << " rows, "
+                 << points / max(seconds, 1e-9) / 1e6 << " Mpoints/s   " << flush;
+        }
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    cerr << "\n";
+
+    if(!writer.close() || (!heatmap.empty() && !heatmap_writer.close())) {
+        cerr << "Cannot write " << output << "\n";
+        delete m;
+        return 1;
+    }
+    // Pixels per second counts the pixels of the image (each of them is iterated twice with histogram coloring)
+    cout << "Rendered " << width << " x " << height << " (" << algorithm_name(algorithm) << ", " << max_iteration
+         << " iterations) in " << seconds << " s: " << (double)width * height / seconds / 1e6 << " Mpixels/s\n";
+    delete m;
+    return 0;
+}
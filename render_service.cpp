@@ -0,0 +1,219 @@
+#include "render_service.h"
+
+render_job::render_job(render_command command) {
+    this -> command = command;
+    x = y = 0;
+    span_x = span_y = 0;
+    p = q = r = s = 0;
+    algorithm = AUTO;
+}
+
+render_service::render_service(MandelbrotSet* set, int width, int height) {
+    this -> set = set;
+    this -> width = width;
+    this -> height = height;
+    busy = false;
+    stopping = false;
+    frame_ready = false;
+    cancelled = 0;
+    // Clicks are on the view of the Set till the window takes the first rendering
+    shown_center_x = set -> get_center_x();
+    shown_center_y = set -> get_center_y();
+    shown_span_x = set -> get_span();
+    shown_span_y = set -> get_span_y();
+    // Previews of progressive renderings are published as soon as they are ready (on the render thread)
+    set -> set_preview_listener([this] { this -> publish(); });
+    worker = thread(&render_service::worker_loop, this);
+}
+
+render_service::~render_service() {
+    {
+        lock_guard<mutex> guard(lock);
+        stopping = true;
+        jobs.clear();
+        set -> request_cancel();
+    }
+    wake_up.notify_all();
+    worker.join();
+    set -> clear_cancel();
+    set -> set_preview_listener(function<void()>());
+}
+
+void render_service::worker_loop() {
+    while(true) {
+        render_job job;
+        {
+            unique_lock<mutex> guard(lock);
+            wake_up.wait(guard, [&] { return stopping || !jobs.empty(); });
+            if(stopping) return;
+            job = jobs.front();
+            jobs.pop_front();
+            busy = true;
+            // A command which already has newer commands behind it is done without rendering
+            // (submit stops the rendering of the last command in the same way)
+            // Heatmap exports do not change the Set, so they do not stop renderings
+            bool newer = false;
+            for(size_t k = 0; k < jobs.size(); k ++) {
+                if(jobs[k].command != EXPORT_HEATMAP) newer = true;
+            }
+            if(newer) set -> request_cancel();
+            else set -> clear_cancel();
+        }
+
+        this -> run_job(job);
+
+        // Only completed renderings (and the previews published while they were rendered) are shown
+        if(set -> is_cancelled()) cancelled ++;
+        else if(set -> is_dirty()) this -> publish();
+        set -> clear_dirty();
+
+        lock_guard<mutex> guard(lock);
+        busy = false;
+    }
+}
+
+void render_service::run_job(const render_job& job) {
+    if(job.command == ZOOM_IN) {
+        double x = job.x;
+        double y = job.y;
+        // Point was clicked on the shown rendering, whose view differs from the view of the Set if newer renderings
+        // were stopped, so it is moved to the pixels of the view of the Set
+        double dcx = (job.center_x - set -> get_center_x()).to_double();
+        double dcy = (job.center_y - set -> get_center_y()).to_double();
+        if(dcx != 0 || dcy != 0 || job.span_x != set -> get_span() || job.span_y != set -> get_span_y()) {
+            x = ((dcx + job.span_x * (x / width - 0.5)) / set -> get_span() + 0.5) * width;
+            y = ((dcy + job.span_y * (y / height - 0.5)) / set -> get_span_y() + 0.5) * height;
+        }
+        set -> zoom_in(x, y);
+        set -> Algorithm(true);
+    }
+    else if(job.command == ZOOM_OUT) set -> zoom_out();
+    else if(job.command == PAN) {
+        // Movement on the shown rendering is scaled to the points of the view of the Set (if newer renderings were stopped)
+        int dx = (int)lround(job.x * job.span_x / set -> get_span());
+        int dy = (int)lround(job.y * job.span_y / set -> get_span_y());
+        set -> pan(dx, dy);
+        set -> Algorithm(true);
+    }
+    else if(job.command == CHANGE_COLORS) set -> change_colors(job.p, job.q, job.r, job.s);
+    else if(job.command == INC_PRECISION) set -> inc_precision();
+    else if(job.command == DEC_PRECISION) set -> dec_precision();
+    else if(job.command == EXPORT_HEATMAP) set -> write_heatmap("heatmap.png");
+    else if(job.command == SET_ALGORITHM) {
+        // Same view rendered again, but not added to the stack (as when precision is changed)
+        set -> set_algorithm(job.algorithm);
+        set -> Algorithm(false);
+    }
+    else set -> Algorithm(true);
+}
+
+void render_service::publish() {
+    lock_guard<mutex> guard(frame_lock);
+    const sf::Color* pixels = (const sf::Color*) set -> get_pixels();
+    frame.pixels.assign(pixels, pixels + width * height);
+    frame.zoom = set -> get_zoom();
+    frame.precision = set -> get_precision();
+    frame.center_x = set -> get_center_x();
+    frame.center_y = set -> get_center_y();
+    frame.span_x = set -> get_span();
+    frame.span_y = set -> get_span_y();
+    frame.telemetry = set -> get_telemetry();
+    frame_ready = true;
+}
+
+void render_service::submit(render_job job) {
+    job.center_x = shown_center_x;
+    job.center_y = shown_center_y;
+    job.span_x = shown_span_x;
+    job.span_y = shown_span_y;
+    {
+        lock_guard<mutex> guard(lock);
+        jobs.push_back(job);
+        // The rendering in progress is stopped (at its next tile), since a newer one is waiting
+        if(busy && job.command != EXPORT_HEATMAP) set -> request_cancel();
+    }
+    wake_up.notify_one();
+}
+
+void render_service::render() {
+    this -> submit(render_job(RENDER));
+}
+
+void render_service::zoom_in(double x, double y) {
+    render_job job(ZOOM_IN);
+    job.x = x;
+    job.y = y;
+    this -> submit(job);
+}
+
+void render_service::zoom_out() {
+    this -> submit(render_job(ZOOM_OUT));
+}
+
+void render_service::pan(int dx, int dy) {
+    render_job job(PAN);
+    job.x = dx;
+    job.y = dy;
+    this -> submit(job);
+}
+
+void render_service::change_colors(int p, int q, int r, int s) {
+    render_job job(CHANGE_COLORS);
+    job.p = p;
+    job.q = q;
+    job.r = r;
+    job.s = s;
+    this -> submit(job);
+}
+
+void render_service::inc_precision() {
+    this -> submit(render_job(INC_PRECISION));
+}
+
+void render_service::dec_precision() {
+    this -> submit(render_job(DEC_PRECISION));
+}
+
+void render_service::export_heatmap() {
+    this -> submit(render_job(EXPORT_HEATMAP));
+}
+
+void render_service::set_algorithm(algorithm_type algorithm) {
+    render_job job(SET_ALGORITHM);
+    job.algorithm = algorithm;
+    this -> submit(job);
+}
+
+bool render_service::take_frame(render_frame& out) {
+    lock_guard<mutex> guard(frame_lock);
+    if(!frame_ready) return false;
+    // Pixels are swapped instead of copied (the next rendering refills the buffer anyway)
+    swap(out.pixels, frame.pixels);
+    out.zoom = frame.zoom;
+    out.precision = frame.precision;
+    out.center_x = frame.center_x;
+    out.center_y = frame.center_y;
+    out.span_x = frame.span_x;
+    out.span_y = frame.span_y;
+    out.telemetry = frame.telemetry;
+    // Commands sent from now on refer to this view
+    shown_center_x = frame.center_x;
+    shown_center_y = frame.center_y;
+    shown_span_x = frame.span_x;
+    shown_span_y = frame.span_y;
+    frame_ready = false;
+    return true;
+}
+
+bool render_service::is_busy() {
+    lock_guard<mutex> guard(lock);
+    return busy || !jobs.empty();
+}
+
+double render_service::get_progress() {
+    return set -> get_progress();
+}
+
+long long render_service::get_cancelled() {
+    return cancelled;
+}
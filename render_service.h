@@ -0,0 +1,125 @@
+#ifndef __RENDER_SERVICE_H__
+#define __RENDER_SERVICE_H__
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "bignum.h"
+#include "mandelbrot.h"
+using namespace std;
+
+// Commands which the window can send to the render service (each of them is done on the Set by the render thread)
+// EXPORT_HEATMAP writes the heatmap of the last rendering to heatmap.png (it does not stop the rendering in progress),
+// and SET_ALGORITHM renders the view again with another algorithm
+enum render_command { RENDER, ZOOM_IN, ZOOM_OUT, PAN, CHANGE_COLORS, INC_PRECISION, DEC_PRECISION, EXPORT_HEATMAP, SET_ALGORITHM };
+
+// A command along with its inputs
+struct render_job {
+    render_command command;
+    // Point clicked for ZOOM_IN, or movement of the view for PAN (in the pixels of the frame shown when it was sent)
+    double x;
+    double y;
+    // View of the frame shown when the command was sent (for ZOOM_IN and PAN)
+    big_number center_x;
+    big_number center_y;
+    double span_x;
+    double span_y;
+    // Inputs of the color palette for CHANGE_COLORS
+    int p;
+    int q;
+    int r;
+    int s;
+    // Algorithm for SET_ALGORITHM
+    algorithm_type algorithm;
+    // Constructor (all inputs 0, algorithm AUTO)
+    render_job(render_command command = RENDER);
+};
+
+// Completed rendering (or preview of a progressive rendering) published by the render service for the window
+struct render_frame {
+    // Colors of all points in the window as RGBA8, row by row (same as the framebuffer of the Set)
+    vector<sf::Color> pixels;
+    // Zoom and precision of the rendering (shown as texts in the window)
+    long long zoom;
+    int precision;
+    // View of the rendering
+    big_number center_x;
+    big_number center_y;
+    double span_x;
+    double span_y;
+    // Telemetry of the rendering (shown by the overlay of the window)
+    telemetry_report telemetry;
+};
+
+// Service rendering the Set on a background thread, so that the window keeps handling events while a rendering is done
+// Commands are queued and done in order; a new command stops the rendering in progress (only its change of view,
+// palette or precision is kept), and commands which already have newer commands behind them are done without rendering
+// The window only shows completed renderings, and the previews of progressive renderings (which are never stopped ones)
+class render_service {
+
+private:
+    // Set which is rendered (only used by the render thread once the service has started)
+    MandelbrotSet* set;
+    // Size of the window
+    int width;
+    int height;
+    // Thread on which all commands are done
+    thread worker;
+    // Commands which have not been started yet
+    deque<render_job> jobs;
+    // Mutex and condition variable protecting the queue, busy and stopping
+    mutex lock;
+    condition_variable wake_up;
+    // Whether a command is being done
+    bool busy;
+    // Set when the service is being destroyed
+    bool stopping;
+    // Last completed rendering or preview, and whether the window has not taken it yet (protected by frame_lock)
+    render_frame frame;
+    bool frame_ready;
+    mutex frame_lock;
+    // View of the last rendering or preview taken by the window (used only by the window thread, which sends it with
+    // its commands, since later renderings may be published before a command is done)
+    big_number shown_center_x;
+    big_number shown_center_y;
+    double shown_span_x;
+    double shown_span_y;
+    // Number of commands whose rendering was stopped or skipped
+    atomic<long long> cancelled;
+
+    // Loop run by the render thread
+    void worker_loop();
+    // Function to do a command on the Set
+    void run_job(const render_job& job);
+    // Function to publish the framebuffer of the Set as the last completed rendering (also called with previews)
+    void publish();
+    // Function to add a command to the queue (with the view shown by the window), stopping the rendering in progress
+    void submit(render_job job);
+
+public:
+    // Constructor (starts the render thread; the Set must not be used by anyone else till the service is destroyed)
+    render_service(MandelbrotSet* set, int width, int height);
+    // Destructor (stops the rendering in progress, drops the queued commands and joins the render thread)
+    ~render_service();
+    // Functions to queue the commands of the window
+    void render();
+    void zoom_in(double x, double y);
+    void zoom_out();
+    void pan(int dx, int dy);
+    void change_colors(int p, int q, int r, int s);
+    void inc_precision();
+    void dec_precision();
+    void export_heatmap();
+    void set_algorithm(algorithm_type algorithm);
+    // Function to take the last completed rendering or preview, if it has not been taken yet (returns false otherwise)
+    bool take_frame(render_frame& out);
+    // Function to check whether commands are being done, and to return the fraction of the current rendering done
+    bool is_busy();
+    double get_progress();
+    // Function to return the number of commands whose rendering was stopped or skipped
+    long long get_cancelled();
+};
+#endif // __RENDER_SERVICE_H__
@@ -1,67 +1,289 @@
 #include <SFML/Graphics.hpp>
 #include "stack.h"
 #include "mandelbrot.h"
+#include "bignum.h"
 #include "run.h"
-#include <time.h>
-#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include <thread>
+#include <vector>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 using namespace std;
 
-void runtimeCalculator()
-{
-    srand(time(0));
-    // Making a Mandelbrot set on a window of size 1000 x 1000
-    int width = 1000;
-    int height = 1000;
+benchmark_options::benchmark_options() {
+    width = 512;
+    height = 512;
+    for(int k = 0; k < BENCHMARK_VIEWPORT_COUNT; k ++) viewports.push_back(BENCHMARK_VIEWPORTS[k].name);
+    for(int a = AUTO; a <= DISTANCE; a ++) kernels.push_back((algorithm_type)a);
+    threads.push_back(0);
+    warmup = 2;
+    runs = 10;
+    seed = 1;
+}
 
-    // Making a color palette with p colors (where p is a random integer from 499 to 999)
+// Value at a fraction of the way through sorted times, interpolating between the two nearest times
+static double percentile(const vector<double>& sorted, double fraction) {
+    double position = fraction * (sorted.size() - 1);
+    int below = (int)position;
+    if(below + 1 >= (int)sorted.size()) return sorted.back();
+    return sorted[below] + (sorted[below + 1] - sorted[below]) * (position - below);
+}
+
+vector<benchmark_result> runBenchmarks(const benchmark_options& options)
+{
+    // Color palette made from the seed in the same way as by the window
+    srand(options.seed);
     int p = 499 + rand() % 501;
-    // q, r, s are random integers in range [2, 999], used to create RGB values in the color palette
     int q = 2 + rand() % 998;
     int r = 2 + rand() % 998;
     int s = 2 + rand() % 998;
+    int cores = thread::hardware_concurrency();
+    if(cores <= 0) cores = 1;
+
+    vector<benchmark_result> results;
+    for(int v = 0; v < BENCHMARK_VIEWPORT_COUNT; v ++) {
+        const benchmark_viewport& viewport = BENCHMARK_VIEWPORTS[v];
+        if(find(options.viewports.begin(), options.viewports.end(), viewport.name) == options.viewports.end()) continue;
+        vector<int> iterations = options.iterations;
+        if(iterations.empty()) iterations.push_back(viewport.max_iteration);
+
+        for(size_t n = 0; n < iterations.size(); n ++) {
+            // A new Set for every max number of iterations, showing the view
+            // Renderings are not pushed to the stack or cached (a cached rendering would not be timed again), so the
+            // memory used stays the same during the benchmark
+            MandelbrotSet* m = new MandelbrotSet(p, options.width, options.height, q, r, s, iterations[n]);
+            m -> set_cache_budget(0);
+            m -> set_stack_budget(0);
+            double spacing = viewport.span / options.width;
+            int limbs = max(limbs_for_spacing(spacing), (int)(strlen(viewport.center_x) * 3.33 / 32) + 2);
+            m -> set_view(big_number(viewport.center_x, limbs), big_number(viewport.center_y, limbs), viewport.span,
+                          viewport.span * options.height / options.width);
+
+            for(size_t t = 0; t < options.threads.size(); t ++) {
+                m -> set_threads(options.threads[t]);
+                for(size_t k = 0; k < options.kernels.size(); k ++) {
+                    algorithm_type kernel = options.kernels[k];
+                    if(viewport.deep && kernel != AUTO && kernel != PERTURBATION) continue;
+                    m -> set_algorithm(kernel);
+
+                    for(int i = 0; i < options.warmup; i ++) m -> Algorithm(false);
+                    vector<double> times;
+                    for(int i = 0; i < options.runs; i ++) {
+                        auto start = chrono::steady_clock::now();
+                        m -> Algorithm(false);
+                        auto end = chrono::steady_clock::now();
+                        chrono::duration<double> diff = end - start;
+                        times.push_back(diff.count());
+                    }
+                    if(times.empty()) continue;
+                    sort(times.begin(), times.end());
+
+                    benchmark_result result;
+                    result.viewport = viewport.name;
+                    result.kernel = kernel;
+                    result.scalar = scalar_type_name(m -> get_last_scalar());
+                    result.threads = options.threads[t] > 0 ? options.threads[t] : cores;
+                    result.max_iteration = iterations[n];
+                    result.runs = times.size();
+                    result.min = times.front();
+                    result.p10 = percentile(times, 0.1);
+                    result.median = percentile(times, 0.5);
+                    result.p90 = percentile(times, 0.9);
+                    result.max = times.back();
+                    result.mean = accumulate(times.begin(), times.end(), 0.0) / times.size();
+                    result.points_per_second = (double)options.width * options.height / result.median;
+                    results.push_back(result);
 
-    // Precision of all algorithms set at 1000
-    int precision = 1000;
+                    cerr << result.viewport << " " << algorithm_name(kernel) << " " << result.threads << " threads "
+                         << result.max_iteration << " iterations: median " << result.median << " s\n";
+                }
+            }
+            m -> set_threads(0);
+            delete m;
+        }
+    }
+    return results;
+}
 
-    MandelbrotSet* m = new MandelbrotSet(p, width, height, q, r, s, precision);
+bool writeBenchmarkCsv(const string& path, const benchmark_options& options, const vector<benchmark_result>& results)
+{
+    ofstream fout;
+    fout.open(path.c_str(), ios::out);
+    fout << "viewport,kernel,scalar,threads,max_iteration,width,height,warmup,runs,min,p10,median,p90,max,mean,points_per_second\n";
+    fout.precision(9);
+    for(size_t k = 0; k < results.size(); k ++) {
+        const benchmark_result& result = results[k];
+        fout << result.viewport << "," << algorithm_name(result.kernel) << "," << result.scalar << "," << result.threads
+             << "," << result.max_iteration << "," << options.width << "," << options.height << "," << options.warmup
+             << "," << result.runs << "," << result.min << "," << result.p10 << "," << result.median << "," << result.p90
+             << "," << result.max << "," << result.mean << "," << result.points_per_second << "\n";
+    }
+    fout.close();
+    return !fout.fail();
+}
 
-    // Running all 5 algorithms N (=10) times and adding the times required to file runtimes.txt
-    int N = 10;
+bool writeBenchmarkJson(const string& path, const benchmark_options& options, const vector<benchmark_result>& results)
+{
     ofstream fout;
-    fout.open("runtimes.txt", ios::out);
-
-    for(int  i = 0; i < N; i ++) {
-        auto start = chrono::system_clock::now();
-        m -> unoptimizedEscapeTime(true);
-        auto end = chrono::system_clock::now();
-        chrono::duration<double> diff = end - start;
-        fout << diff.count() << " ";
-
-        start = chrono::system_clock::now();
-        m -> optimizedEscapeTime(true);
-        end = chrono::system_clock::now();
-        diff = end - start;
-        fout << diff.count() << " ";
-
-        start = chrono::system_clock::now();
-        m -> periodicallyCheckedEscapeTime(true);
-        end = chrono::system_clock::now();
-        diff = end - start;
-        fout << diff.count() << " ";
-
-        start = chrono::system_clock::now();
-        m -> continuousColoring(true);
-        end = chrono::system_clock::now();
-        diff = end - start;
-        fout << diff.count() << " ";
-
-        start = chrono::system_clock::now();
-        m -> histogramColoring(true);
-        end = chrono::system_clock::now();
-        diff = end - start;
-        fout << diff.count() << "\n";
+    fout.open(path.c_str(), ios::out);
+    fout.precision(9);
+    fout << "{\n  \"width\": " << options.width << ",\n  \"height\": " << options.height << ",\n  \"warmup\": "
+         << options.warmup << ",\n  \"runs\": " << options.runs << ",\n  \"seed\": " << options.seed
+         << ",\n  \"cores\": " << thread::hardware_concurrency() << ",\n  \"results\": [";
+    for(size_t k = 0; k < results.size(); k ++) {
+        const benchmark_result& result = results[k];
+        fout << (k > 0 ? "," : "") << "\n    {\"viewport\": \"" << result.viewport << "\", \"kernel\": \""
+             << algorithm_name(result.kernel) << "\", \"scalar\": \"" << result.scalar << "\", \"threads\": "
+             << result.threads << ", \"max_iteration\": " << result.max_iteration << ", \"runs\": " << result.runs
+             << ", \"min\": " << result.min << ", \"p10\": " << result.p10 << ", \"median\": " << result.median
+             << ", \"p90\": " << result.p90 << ", \"max\": " << result.max << ", \"mean\": " << result.mean
+             << ", \"points_per_second\": " << result.points_per_second << "}";
+    }
+    fout << "\n  ]\n}\n";
+    fout.close();
+    return !fout.fail();
+}
+
+void runtimeCalculator()
+{
+    // All algorithms on all views of the catalog, with 1, 2, 4, ... threads up to the number of cores
+    benchmark_options options;
+    int cores = thread::hardware_concurrency();
+    if(cores <= 0) cores = 1;
+    options.threads.clear();
+    for(int t = 1; t < cores; t *= 2) options.threads.push_back(t);
+    options.threads.push_back(cores);
+
+    vector<benchmark_result> results = runBenchmarks(options);
+    writeBenchmarkCsv("runtimes.csv", options, results);
+    writeBenchmarkJson("runtimes.json", options, results);
+
+    layoutBenchmark(1000, 1000);
+}
+
+// Counter of the cache misses of the calling thread (from the hardware performance counters of Linux)
+// Elsewhere, or if the counters cannot be opened (e.g. they are not permitted), it counts nothing and returns -1
+class miss_counter {
+
+private:
+    int fd;
+
+public:
+    miss_counter() {
+        fd = -1;
+#ifdef __linux__
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+    ~miss_counter() {
+#ifdef __linux__
+        if(fd >= 0) close(fd);
+#endif
+    }
+    // Function to start counting from 0
+    void start() {
+#ifdef __linux__
+        if(fd < 0) return;
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    // Function to stop counting and return the misses counted since start (-1 if not available)
+    long long stop() {
+#ifdef __linux__
+        long long misses;
+        if(fd < 0) return -1;
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if(read(fd, &misses, sizeof(misses)) == sizeof(misses)) return misses;
+#endif
+        return -1;
+    }
+};
+
+// Function to count the cache lines of 64 bytes loaded by a pass over a buffer of elements of a size, in column-major
+// or row-major order, if only the last line used stays in the cache (an access to another line is a miss)
+// This does not depend on the machine, unlike the time and the counted misses
+static long long lines_loaded(int width, int height, size_t element, bool row_major) {
+    long long lines = 0;
+    size_t last = (size_t)-1;
+    for(int a = 0; a < (row_major ? height : width); a ++) {
+        for(int b = 0; b < (row_major ? width : height); b ++) {
+            size_t index = row_major ? (size_t)a*width + b : (size_t)b*width + a;
+            size_t line = index * element / 64;
+            if(line != last) lines ++;
+            last = line;
+        }
+    }
+    return lines;
+}
+
+void layoutBenchmark(int width, int height)
+{
+    // Buffers of the same size as those of a rendering, filled with some iteration counts
+    vector<int> iterations(width * height);
+    vector<sf::Color> framebuffer(width * height);
+    vector<sf::Color> palette(256);
+    for(int k = 0; k < width * height; k ++) iterations[k] = k % 1000;
+    for(int k = 0; k < 256; k ++) palette[k] = sf::Color(k, 255 - k, k / 2);
+
+    // Coloring pass (as in recolor) is done R (=20) times with both traversal orders
+    // Column by column (old order), consecutive points are width elements apart, so almost every access is
+    // to a new cache line; row by row, points are read and written sequentially
+    // Along with the time of a pass, the cache misses counted by the processor (if available) and the cache lines
+    // loaded from the iteration buffer and the framebuffer (as found by lines_loaded) are written
+    int R = 20;
+    ofstream fout;
+    fout.open("layout.txt", ios::out);
+    miss_counter counter;
+
+    counter.start();
+    auto start = chrono::steady_clock::now();
+    for(int r = 0; r < R; r ++) {
+        for(int i = 0; i < width; i ++) {
+            for(int j = 0; j < height; j ++) {
+                framebuffer[j*width + i] = palette[(iterations[j*width + i] + r) % 256];
+            }
+        }
+    }
+    auto end = chrono::steady_clock::now();
+    long long misses = counter.stop();
+    chrono::duration<double> diff = end - start;
+    fout << "column-major " << diff.count() / R << " s, " << (misses < 0 ? -1 : misses / R) << " cache misses, "
+         << lines_loaded(width, height, sizeof(int), false) + lines_loaded(width, height, sizeof(sf::Color), false)
+         << " cache lines loaded\n";
+
+    counter.start();
+    start = chrono::steady_clock::now();
+    for(int r = 0; r < R; r ++) {
+        for(int j = 0; j < height; j ++) {
+            for(int i = 0; i < width; i ++) {
+                framebuffer[j*width + i] = palette[(iterations[j*width + i] + r) % 256];
+            }
+        }
     }
+    end = chrono::steady_clock::now();
+    misses = counter.stop();
+    diff = end - start;
+    fout << "row-major " << diff.count() / R << " s, " << (misses < 0 ? -1 : misses / R) << " cache misses, "
+         << lines_loaded(width, height, sizeof(int), true) + lines_loaded(width, height, sizeof(sf::Color), true)
+         << " cache lines loaded\n";
+    fout.close();
 }
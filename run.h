@@ -1,6 +1,81 @@
 #ifndef __RUN_H__
 #define __RUN_H__
+#include "mandelbrot.h"
+#include <string>
+#include <vector>
+using namespace std;
 
-// Function to find and compare run times of the 5 different plotting algorithms
+// View of the benchmark catalog, with the max number of iterations it is rendered with by default
+// Deep views need the perturbation algorithm (other algorithms would need double-double or fixed point numbers, and take
+// minutes), so only AUTO and PERTURBATION are timed on them
+struct benchmark_viewport {
+    const char* name;
+    const char* center_x;
+    const char* center_y;
+    double span;
+    int max_iteration;
+    bool deep;
+};
+
+// Views of the catalog: the initial view, seahorse valley, a minibrot of period 20 at width 1.5e-19 (on the real axis
+// near -2), and a view inside the period-3 bulb (all points reach max_iteration, and none is skipped by the interior check)
+const benchmark_viewport BENCHMARK_VIEWPORTS[] = {
+    {"home", "-0.765", "0", 3.3, 1000, false},
+    {"seahorse-valley", "-0.7453", "0.1127", 6.5e-4, 1000, false},
+    {"deep-minibrot", "-1.99999999018435783548653711322256", "0", 1.5e-19, 5000, true},
+    {"all-interior", "-0.1225611668766536", "0.7448617666197442", 0.05, 1000, false}
+};
+const int BENCHMARK_VIEWPORT_COUNT = 4;
+
+// Options of a benchmark run
+struct benchmark_options {
+    // Size of the renderings
+    int width;
+    int height;
+    // Names of the views, algorithms, thread counts (0 is one per core) and max numbers of iterations to time, every
+    // combination being timed (no iterations means the default of every view)
+    vector<string> viewports;
+    vector<algorithm_type> kernels;
+    vector<int> threads;
+    vector<int> iterations;
+    // Number of untimed renderings before the timed ones, and number of timed renderings
+    int warmup;
+    int runs;
+    // Seed of the color palette (fixed, so that every run renders the same plots)
+    unsigned int seed;
+    // Constructor with the default options (512 x 512, all views and algorithms, one thread per core, 2 warmup and
+    // 10 timed renderings, seed 1)
+    benchmark_options();
+};
+
+// Times of the renderings of one combination (in seconds)
+struct benchmark_result {
+    string viewport;
+    algorithm_type kernel;
+    // Scalar type used by the last rendering
+    string scalar;
+    int threads;
+    int max_iteration;
+    int runs;
+    double min;
+    double p10;
+    double median;
+    double p90;
+    double max;
+    double mean;
+    // Points rendered per second (at the median time)
+    double points_per_second;
+};
+
+// Function to time the renderings of all combinations of the options (progress is printed to cerr)
+vector<benchmark_result> runBenchmarks(const benchmark_options& options);
+// Functions to write the results as CSV (one line per combination, with a header) and as JSON (with the options)
+bool writeBenchmarkCsv(const string& path, const benchmark_options& options, const vector<benchmark_result>& results);
+bool writeBenchmarkJson(const string& path, const benchmark_options& options, const vector<benchmark_result>& results);
+// Function to find and compare run times of the plotting algorithms on all views of the catalog, for 1, 2, 4, ... threads
+// up to the number of cores (written to runtimes.csv and runtimes.json, which plot.py plots)
 void runtimeCalculator();
+// Function to compare the time and the cache misses of a pass over the buffers of a rendering in column-major and
+// row-major order (written to layout.txt, called by runtimeCalculator)
+void layoutBenchmark(int width, int height);
 #endif // __RUN_H__
@@ -0,0 +1,25 @@
+#include "scalar.h"
+#include <cfloat>
+
+const char* scalar_type_name(scalar_type type) {
+    if(type == SCALAR_FLOAT) return "float";
+    if(type == SCALAR_DOUBLE) return "double";
+    if(type == SCALAR_LONG_DOUBLE) return "long double";
+    if(type == SCALAR_DOUBLE_DOUBLE) return "double-double";
+    if(type == SCALAR_FIXED128) return "fixed128";
+    return "auto";
+}
+
+double scalar_resolution(scalar_type type, double magnitude) {
+    // Floating point types resolve distances relative to the magnitude of the numbers (half an ulp)
+    if(type == SCALAR_FLOAT) return magnitude * FLT_EPSILON / 2;
+    if(type == SCALAR_DOUBLE) return magnitude * DBL_EPSILON / 2;
+    if(type == SCALAR_LONG_DOUBLE) return magnitude * LDBL_EPSILON / 2;
+    // Double-double has about 106 bits (2^(-106) relative)
+    if(type == SCALAR_DOUBLE_DOUBLE) return magnitude * ldexp(1.0, -106);
+#ifdef MANDELBROT_FIXED128
+    // Fixed point resolves the same distance everywhere
+    if(type == SCALAR_FIXED128) return ldexp(1.0, -120);
+#endif
+    return 0;
+}
@@ -0,0 +1,166 @@
+#ifndef __SCALAR_H__
+#define __SCALAR_H__
+#include <cmath>
+using namespace std;
+
+// 128-bit fixed point numbers need the __int128 type of GCC/Clang (64-bit targets only)
+#if defined(__SIZEOF_INT128__)
+#define MANDELBROT_FIXED128
+#endif
+
+// Scalar types in which the optimized escape time iteration can be done
+// Each type resolves smaller distances than the one before it (for points of size about 1)
+// SCALAR_AUTO picks the cheapest type which can tell adjacent points of the view apart
+enum scalar_type { SCALAR_AUTO, SCALAR_FLOAT, SCALAR_DOUBLE, SCALAR_LONG_DOUBLE, SCALAR_DOUBLE_DOUBLE, SCALAR_FIXED128 };
+
+// Function to return the name of a scalar type (used while printing runtimes)
+const char* scalar_type_name(scalar_type type);
+// Function to return the smallest distance between adjacent points which a scalar type can resolve,
+// for points of absolute value up to magnitude (0 if the type is not available)
+double scalar_resolution(scalar_type type, double magnitude);
+
+// Double-double number: unevaluated sum hi + lo of two doubles with |lo| <= ulp(hi) / 2, giving about 106 bits
+// Uses the error-free transformations of Knuth (sum) and Dekker (product), so it needs strict IEEE double arithmetic
+// (no fused multiply-add contraction and no extended precision registers)
+struct double_double {
+    double hi;
+    double lo;
+    double_double() : hi(0), lo(0) {}
+    double_double(double value) : hi(value), lo(0) {}
+    double_double(double hi, double lo) : hi(hi), lo(lo) {}
+};
+
+// s + e = a + b exactly
+static inline void two_sum(double a, double b, double& s, double& e) {
+    s = a + b;
+    double bb = s - a;
+    e = (a - (s - bb)) + (b - bb);
+}
+
+// s + e = a + b exactly (requires |a| >= |b|)
+static inline void quick_two_sum(double a, double b, double& s, double& e) {
+    s = a + b;
+    e = b - (s - a);
+}
+
+// p + e = a * b exactly (a and b are split into halves of 26 bits, whose products are exact)
+static inline void two_prod(double a, double b, double& p, double& e) {
+    const double split = 134217729.0;
+    double t = split * a;
+    double ah = t - (t - a);
+    double al = a - ah;
+    t = split * b;
+    double bh = t - (t - b);
+    double bl = b - bh;
+    p = a * b;
+    e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+}
+
+static inline double_double operator+(const double_double& a, const double_double& b) {
+    double s, e, t, f;
+    two_sum(a.hi, b.hi, s, e);
+    two_sum(a.lo, b.lo, t, f);
+    e += t;
+    quick_two_sum(s, e, s, e);
+    e += f;
+    quick_two_sum(s, e, s, e);
+    return double_double(s, e);
+}
+
+static inline double_double operator-(const double_double& a) {
+    return double_double(-a.hi, -a.lo);
+}
+
+static inline double_double operator-(const double_double& a, const double_double& b) {
+    return a + (-b);
+}
+
+static inline double_double operator*(const double_double& a, const double_double& b) {
+    double p, e;
+    two_prod(a.hi, b.hi, p, e);
+    e += a.hi * b.lo + a.lo * b.hi;
+    quick_two_sum(p, e, p, e);
+    return double_double(p, e);
+}
+
+static inline bool operator<=(const double_double& a, const double_double& b) {
+    return a.hi < b.hi || (a.hi == b.hi && a.lo <= b.lo);
+}
+
+#ifdef MANDELBROT_FIXED128
+// Fixed point number with 8 integer bits (including sign) and 120 fractional bits, stored in a signed __int128
+// Values up to 128 are enough for orbits till they escape (|z| <= 2 before an iteration, so |z|^2 < 64 after it),
+// and the resolution is 2^(-120), about 7.5e-37, without any floating point rounding
+struct fixed128 {
+    __int128 raw;
+    fixed128() : raw(0) {}
+    fixed128(double value) : raw((__int128)rint(ldexp(value, 120))) {}
+    static fixed128 from_raw(__int128 raw) {
+        fixed128 result;
+        result.raw = raw;
+        return result;
+    }
+};
+
+static inline fixed128 operator+(const fixed128& a, const fixed128& b) {
+    return fixed128::from_raw(a.raw + b.raw);
+}
+
+static inline fixed128 operator-(const fixed128& a, const fixed128& b) {
+    return fixed128::from_raw(a.raw - b.raw);
+}
+
+static inline fixed128 operator*(const fixed128& a, const fixed128& b) {
+    // Product of the magnitudes is found in 256 bits from four 64 x 64 bit products, and bits 120 to 247 are kept
+    // (rounded to nearest, so that rounding errors do not add up in one direction over the iterations)
+    bool negative = (a.raw < 0) != (b.raw < 0);
+    unsigned __int128 ua = a.raw < 0 ? -(unsigned __int128)a.raw : (unsigned __int128)a.raw;
+    unsigned __int128 ub = b.raw < 0 ? -(unsigned __int128)b.raw : (unsigned __int128)b.raw;
+    unsigned __int128 a1 = ua >> 64;
+    unsigned __int128 a0 = (unsigned long long)ua;
+    unsigned __int128 b1 = ub >> 64;
+    unsigned __int128 b0 = (unsigned long long)ub;
+
+    unsigned __int128 low = a0 * b0;
+    unsigned __int128 mid1 = a1 * b0;
+    unsigned __int128 mid2 = a0 * b1;
+    unsigned __int128 high = a1 * b1;
+    unsigned __int128 middle = (low >> 64) + (unsigned long long)mid1 + (unsigned long long)mid2;
+    low = (middle << 64) | (unsigned long long)low;
+    high += (mid1 >> 64) + (mid2 >> 64) + (middle >> 64);
+    unsigned __int128 rounded = low + ((unsigned __int128)1 << 119);
+    if(rounded < low) high ++;
+    low = rounded;
+
+    unsigned __int128 product = (high << 8) | (low >> 120);
+    return fixed128::from_raw(negative ? -(__int128)product : (__int128)product);
+}
+
+static inline bool operator<=(const fixed128& a, const fixed128& b) {
+    return a.raw <= b.raw;
+}
+#endif // MANDELBROT_FIXED128
+
+// Functions to convert a value of any scalar type to the nearest double
+static inline double to_double(float value) {
+    return value;
+}
+
+static inline double to_double(double value) {
+    return value;
+}
+
+static inline double to_double(long double value) {
+    return (double)value;
+}
+
+static inline double to_double(const double_double& value) {
+    return value.hi + value.lo;
+}
+
+#ifdef MANDELBROT_FIXED128
+static inline double to_double(const fixed128& value) {
+    return ldexp((double)value.raw, -120);
+}
+#endif
+#endif // __SCALAR_H__
@@ -0,0 +1,593 @@
+#include "simd.h"
+#include <cmath>
+
+// Vector instructions are used only with GCC/Clang on x86 processors (otherwise everything runs on the scalar version)
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define MANDELBROT_X86_SIMD
+#include <immintrin.h>
+#endif
+
+simd_output::simd_output() {
+    x = y = xold = yold = 0;
+    periods = 0;
+    saved_at = 0;
+}
+
+// Saving the optional outputs of point k
+static inline void save_output(const simd_output& out, int k, double x, double y, double xold, double yold, int period, int saved_at) {
+    if(out.x) out.x[k] = x;
+    if(out.y) out.y[k] = y;
+    if(out.xold) out.xold[k] = xold;
+    if(out.yold) out.yold[k] = yold;
+    if(out.periods) out.periods[k] = period;
+    if(out.saved_at) out.saved_at[k] = saved_at;
+}
+
+// Scalar version, same as the optimized escape time algorithm (with Brent's cycle detection if tolerance > 0),
+// in doubles or floats (T)
+// Also used for the points k, ..., n - 1 left over by the vectorized versions (n % lanes of them)
+// It is never inlined into them, since the compiler may then fuse its multiplications and additions
+// (changing the rounding) when the AVX-512 instruction set is enabled
+template<typename T>
+#ifdef MANDELBROT_X86_SIMD
+__attribute__((noinline))
+#endif
+static void escape_scalar(const T* x0, const T* y0, int k, int n, int max_iteration, double tolerance, int* iterations, const simd_output& out) {
+    for(; k < n; k ++) {
+        T x = 0;
+        T y = 0;
+        T x2 = 0;
+        T y2 = 0;
+        // Value of z saved at iteration saved_at (last power of 2) for cycle detection
+        T xold = 0;
+        T yold = 0;
+        int saved_at = 0;
+        int period = 0;
+        int iteration = 0;
+        while(x2 + y2 <= 4 && iteration < max_iteration) {
+            y = (x + x) * y + y0[k];
+            x = x2 - y2 + x0[k];
+            x2 = x * x;
+            y2 = y * y;
+            iteration ++;
+
+            if(tolerance > 0) {
+                if(fabs(x - xold) < tolerance && fabs(y - yold) < tolerance) {
+                    period = iteration - saved_at;
+                    iteration = max_iteration;
+                    break;
+                }
+                if((iteration & (iteration - 1)) == 0) {
+                    xold = x;
+                    yold = y;
+                    saved_at = iteration;
+                }
+            }
+        }
+        iterations[k] = iteration;
+        save_output(out, k, x, y, xold, yold, period, period > 0 ? saved_at : 0);
+    }
+}
+
+#ifdef MANDELBROT_X86_SIMD
+
+// All vectorized versions follow the same scheme:
+// Each lane holds one point, and all lanes are iterated together with the same operations (in the same order)
+// as the scalar version, so that the iteration counts are bit-identical
+// Lanes which have escaped (or reached max_iteration) are masked out, i.e. their x, y and iteration count stay frozen
+// The loop ends when all lanes are masked out
+// Iteration counts are kept as doubles (exact for all counts below 2^53), so that no integer vector instructions are needed
+// All active lanes have done the same number of iterations (step), so cycle detection saves z in all of them at the same
+// steps (powers of 2), and only the comparison with the saved value is done lane by lane
+
+// Storing the optional outputs of the lanes of a vector (copied to arrays first, since lanes cannot be indexed directly)
+static inline void save_lanes(const simd_output& out, int k, int lanes, const double* x, const double* y,
+                              const double* xold, const double* yold, const double* period, const double* saved_at) {
+    for(int l = 0; l < lanes; l ++) {
+        save_output(out, k + l, x[l], y[l], xold[l], yold[l], (int)period[l], (int)saved_at[l]);
+    }
+}
+
+// SSE2 version (2 points at a time)
+__attribute__((target("sse2")))
+static void escape_sse2(const double* x0, const double* y0, int n, int max_iteration, double tolerance, int* iterations, const simd_output& out) {
+    const __m128d four = _mm_set1_pd(4.0);
+    const __m128d one = _mm_set1_pd(1.0);
+    const __m128d max_it = _mm_set1_pd(max_iteration);
+    const __m128d tol = _mm_set1_pd(tolerance);
+    // Absolute value is found by clearing the sign bit
+    const __m128d sign = _mm_set1_pd(-0.0);
+
+    int k = 0;
+    for(; k + 2 <= n; k += 2) {
+        __m128d cx = _mm_loadu_pd(x0 + k);
+        __m128d cy = _mm_loadu_pd(y0 + k);
+        __m128d x = _mm_setzero_pd();
+        __m128d y = _mm_setzero_pd();
+        __m128d x2 = _mm_setzero_pd();
+        __m128d y2 = _mm_setzero_pd();
+        __m128d it = _mm_setzero_pd();
+        __m128d xold = _mm_setzero_pd();
+        __m128d yold = _mm_setzero_pd();
+        __m128d period = _mm_setzero_pd();
+        // Iteration at which the value of z a periodic lane came back to was saved
+        __m128d period_saved_at = _mm_setzero_pd();
+        int step = 0;
+        int saved_at = 0;
+
+        while(true) {
+            // Lane is active if x2 + y2 <= 4 and iteration < max_iteration
+            __m128d active = _mm_and_pd(_mm_cmple_pd(_mm_add_pd(x2, y2), four), _mm_cmplt_pd(it, max_it));
+            if(_mm_movemask_pd(active) == 0) break;
+
+            // y = (x + x) * y + y0 and x = x2 - y2 + x0, updated only in active lanes
+            __m128d new_y = _mm_add_pd(_mm_mul_pd(_mm_add_pd(x, x), y), cy);
+            __m128d new_x = _mm_add_pd(_mm_sub_pd(x2, y2), cx);
+            y = _mm_or_pd(_mm_and_pd(active, new_y), _mm_andnot_pd(active, y));
+            x = _mm_or_pd(_mm_and_pd(active, new_x), _mm_andnot_pd(active, x));
+            x2 = _mm_mul_pd(x, x);
+            y2 = _mm_mul_pd(y, y);
+            it = _mm_add_pd(it, _mm_and_pd(active, one));
+            step ++;
+
+            if(tolerance > 0) {
+                // Active lanes close to their saved value are periodic, so they jump to max_iteration
+                __m128d close_x = _mm_cmplt_pd(_mm_andnot_pd(sign, _mm_sub_pd(x, xold)), tol);
+                __m128d close_y = _mm_cmplt_pd(_mm_andnot_pd(sign, _mm_sub_pd(y, yold)), tol);
+                __m128d periodic = _mm_and_pd(active, _mm_and_pd(close_x, close_y));
+                it = _mm_or_pd(_mm_and_pd(periodic, max_it), _mm_andnot_pd(periodic, it));
+                period = _mm_or_pd(_mm_and_pd(periodic, _mm_set1_pd(step - saved_at)), _mm_andnot_pd(periodic, period));
+                period_saved_at = _mm_or_pd(_mm_and_pd(periodic, _mm_set1_pd(saved_at)), _mm_andnot_pd(periodic, period_saved_at));
+                // Other active lanes save z if step is a power of 2
+                if((step & (step - 1)) == 0) {
+                    __m128d save = _mm_andnot_pd(periodic, active);
+                    xold = _mm_or_pd(_mm_and_pd(save, x), _mm_andnot_pd(save, xold));
+                    yold = _mm_or_pd(_mm_and_pd(save, y), _mm_andnot_pd(save, yold));
+                    saved_at = step;
+                }
+            }
+        }
+        _mm_storel_epi64((__m128i*)(iterations + k), _mm_cvttpd_epi32(it));
+
+        double lx[2], ly[2], lxold[2], lyold[2], lperiod[2], lsaved_at[2];
+        _mm_storeu_pd(lx, x);
+        _mm_storeu_pd(ly, y);
+        _mm_storeu_pd(lxold, xold);
+        _mm_storeu_pd(lyold, yold);
+        _mm_storeu_pd(lperiod, period);
+        _mm_storeu_pd(lsaved_at, period_saved_at);
+        save_lanes(out, k, 2, lx, ly, lxold, lyold, lperiod, lsaved_at);
+    }
+    escape_scalar(x0, y0, k, n, max_iteration, tolerance, iterations, out);
+}
+
+// AVX2 version (4 points at a time)
+__attribute__((target("avx2")))
+static void escape_avx2(const double* x0, const double* y0, int n, int max_iteration, double tolerance, int* iterations, const simd_output& out) {
+    const __m256d four = _mm256_set1_pd(4.0);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d max_it = _mm256_set1_pd(max_iteration);
+    const __m256d tol = _mm256_set1_pd(tolerance);
+    const __m256d sign = _mm256_set1_pd(-0.0);
+
+    int k = 0;
+    for(; k + 4 <= n; k += 4) {
+        __m256d cx = _mm256_loadu_pd(x0 + k);
+        __m256d cy = _mm256_loadu_pd(y0 + k);
+        __m256d x = _mm256_setzero_pd();
+        __m256d y = _mm256_setzero_pd();
+        __m256d x2 = _mm256_setzero_pd();
+        __m256d y2 = _mm256_setzero_pd();
+        __m256d it = _mm256_setzero_pd();
+        __m256d xold = _mm256_setzero_pd();
+        __m256d yold = _mm256_setzero_pd();
+        __m256d period = _mm256_setzero_pd();
+        __m256d period_saved_at = _mm256_setzero_pd();
+        int step = 0;
+        int saved_at = 0;
+
+        while(true) {
+            __m256d small = _mm256_cmp_pd(_mm256_add_pd(x2, y2), four, _CMP_LE_OQ);
+            __m256d active = _mm256_and_pd(small, _mm256_cmp_pd(it, max_it, _CMP_LT_OQ));
+            if(_mm256_movemask_pd(active) == 0) break;
+
+            __m256d new_y = _mm256_add_pd(_mm256_mul_pd(_mm256_add_pd(x, x), y), cy);
+            __m256d new_x = _mm256_add_pd(_mm256_sub_pd(x2, y2), cx);
+            y = _mm256_blendv_pd(y, new_y, active);
+            x = _mm256_blendv_pd(x, new_x, active);
+            x2 = _mm256_mul_pd(x, x);
+            y2 = _mm256_mul_pd(y, y);
+            it = _mm256_add_pd(it, _mm256_and_pd(active, one));
+            step ++;
+
+            if(tolerance > 0) {
+                __m256d close_x = _mm256_cmp_pd(_mm256_andnot_pd(sign, _mm256_sub_pd(x, xold)), tol, _CMP_LT_OQ);
+                __m256d close_y = _mm256_cmp_pd(_mm256_andnot_pd(sign, _mm256_sub_pd(y, yold)), tol, _CMP_LT_OQ);
+                __m256d periodic = _mm256_and_pd(active, _mm256_and_pd(close_x, close_y));
+                it = _mm256_blendv_pd(it, max_it, periodic);
+                period = _mm256_blendv_pd(period, _mm256_set1_pd(step - saved_at), periodic);
+                period_saved_at = _mm256_blendv_pd(period_saved_at, _mm256_set1_pd(saved_at), periodic);
+                if((step & (step - 1)) == 0) {
+                    __m256d save = _mm256_andnot_pd(periodic, active);
+                    xold = _mm256_blendv_pd(xold, x, save);
+                    yold = _mm256_blendv_pd(yold, y, save);
+                    saved_at = step;
+                }
+            }
+        }
+        _mm_storeu_si128((__m128i*)(iterations + k), _mm256_cvttpd_epi32(it));
+
+        double lx[4], ly[4], lxold[4], lyold[4], lperiod[4], lsaved_at[4];
+        _mm256_storeu_pd(lx, x);
+        _mm256_storeu_pd(ly, y);
+        _mm256_storeu_pd(lxold, xold);
+        _mm256_storeu_pd(lyold, yold);
+        _mm256_storeu_pd(lperiod, period);
+        _mm256_storeu_pd(lsaved_at, period_saved_at);
+        save_lanes(out, k, 4, lx, ly, lxold, lyold, lperiod, lsaved_at);
+    }
+    // Upper halves of the vector registers are cleared before going back to code without AVX instructions (which
+    // would otherwise be slowed down by every transition, e.g. a continuous coloring rendering after this one)
+    _mm256_zeroupper();
+    escape_scalar(x0, y0, k, n, max_iteration, tolerance, iterations, out);
+}
+
+// AVX-512 version (8 points at a time), uses mask registers instead of blending
+__attribute__((target("avx512f")))
+static void escape_avx512(const double* x0, const double* y0, int n, int max_iteration, double tolerance, int* iterations, const simd_output& out) {
+    const __m512d four = _mm512_set1_pd(4.0);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d max_it = _mm512_set1_pd(max_iteration);
+    const __m512d tol = _mm512_set1_pd(tolerance);
+
+    int k = 0;
+    for(; k + 8 <= n; k += 8) {
+        __m512d cx = _mm512_loadu_pd(x0 + k);
+        __m512d cy = _mm512_loadu_pd(y0 + k);
+        __m512d x = _mm512_setzero_pd();
+        __m512d y = _mm512_setzero_pd();
+        __m512d x2 = _mm512_setzero_pd();
+        __m512d y2 = _mm512_setzero_pd();
+        __m512d it = _mm512_setzero_pd();
+        __m512d xold = _mm512_setzero_pd();
+        __m512d yold = _mm512_setzero_pd();
+        __m512d period = _mm512_setzero_pd();
+        __m512d period_saved_at = _mm512_setzero_pd();
+        int step = 0;
+        int saved_at = 0;
+
+        while(true) {
+            __mmask8 active = _mm512_cmp_pd_mask(_mm512_add_pd(x2, y2), four, _CMP_LE_OQ);
+            active &= _mm512_cmp_pd_mask(it, max_it, _CMP_LT_OQ);
+            if(active == 0) break;
+
+            // Multiplication with explicit rounding cannot be fused with the addition (AVX-512 has fused multiply-add),
+            // so rounding is the same as in the scalar version
+            __m512d new_y = _mm512_add_pd(_mm512_mul_round_pd(_mm512_add_pd(x, x), y, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), cy);
+            __m512d new_x = _mm512_add_pd(_mm512_sub_pd(x2, y2), cx);
+            y = _mm512_mask_mov_pd(y, active, new_y);
+            x = _mm512_mask_mov_pd(x, active, new_x);
+            x2 = _mm512_mul_pd(x, x);
+            y2 = _mm512_mul_pd(y, y);
+            it = _mm512_mask_add_pd(it, active, it, one);
+            step ++;
+
+            if(tolerance > 0) {
+                __mmask8 periodic = active & _mm512_cmp_pd_mask(_mm512_abs_pd(_mm512_sub_pd(x, xold)), tol, _CMP_LT_OQ);
+                periodic &= _mm512_cmp_pd_mask(_mm512_abs_pd(_mm512_sub_pd(y, yold)), tol, _CMP_LT_OQ);
+                it = _mm512_mask_mov_pd(it, periodic, max_it);
+                period = _mm512_mask_mov_pd(period, periodic, _mm512_set1_pd(step - saved_at));
+                period_saved_at = _mm512_mask_mov_pd(period_saved_at, periodic, _mm512_set1_pd(saved_at));
+                if((step & (step - 1)) == 0) {
+                    __mmask8 save = active & ~periodic;
+                    xold = _mm512_mask_mov_pd(xold, save, x);
+                    yold = _mm512_mask_mov_pd(yold, save, y);
+                    saved_at = step;
+                }
+            }
+        }
+        _mm256_storeu_si256((__m256i*)(iterations + k), _mm512_cvttpd_epi32(it));
+
+        double lx[8], ly[8], lxold[8], lyold[8], lperiod[8], lsaved_at[8];
+        _mm512_storeu_pd(lx, x);
+        _mm512_storeu_pd(ly, y);
+        _mm512_storeu_pd(lxold, xold);
+        _mm512_storeu_pd(lyold, yold);
+        _mm512_storeu_pd(lperiod, period);
+        _mm512_storeu_pd(lsaved_at, period_saved_at);
+        save_lanes(out, k, 8, lx, ly, lxold, lyold, lperiod, lsaved_at);
+    }
+    // Upper halves of the vector registers are cleared before going back to code without AVX instructions (which
+    // would otherwise be slowed down by every transition, e.g. a continuous coloring rendering after this one)
+    _mm256_zeroupper();
+    escape_scalar(x0, y0, k, n, max_iteration, tolerance, iterations, out);
+}
+
+// Float versions, with twice as many lanes in each vector (same scheme as above)
+// Iteration counts are kept as floats (exact for all counts below 2^24)
+// Cycle detection compares the float distance to the saved value with the largest float below the (double)
+// tolerance, which is the same as comparing it with the tolerance itself (as the scalar version does)
+
+// Storing the optional outputs of the lanes of a float vector (floats are converted to doubles exactly)
+static inline void save_float_lanes(const simd_output& out, int k, int lanes, const float* x, const float* y,
+                                    const float* xold, const float* yold, const float* period, const float* saved_at) {
+    for(int l = 0; l < lanes; l ++) {
+        save_output(out, k + l, x[l], y[l], xold[l], yold[l], (int)period[l], (int)saved_at[l]);
+    }
+}
+
+// SSE2 version (4 points at a time)
+__attribute__((target("sse2")))
+static void escape_sse2(const float* x0, const float* y0, int n, int max_iteration, double tolerance, float tolerance_below, int* iterations, const simd_output& out) {
+    const __m128 four = _mm_set1_ps(4.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 max_it = _mm_set1_ps(max_iteration);
+    const __m128 tol = _mm_set1_ps(tolerance_below);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+
+    int k = 0;
+    for(; k + 4 <= n; k += 4) {
+        __m128 cx = _mm_loadu_ps(x0 + k);
+        __m128 cy = _mm_loadu_ps(y0 + k);
+        __m128 x = _mm_setzero_ps();
+        __m128 y = _mm_setzero_ps();
+        __m128 x2 = _mm_setzero_ps();
+        __m128 y2 = _mm_setzero_ps();
+        __m128 it = _mm_setzero_ps();
+        __m128 xold = _mm_setzero_ps();
+        __m128 yold = _mm_setzero_ps();
+        __m128 period = _mm_setzero_ps();
+        __m128 period_saved_at = _mm_setzero_ps();
+        int step = 0;
+        int saved_at = 0;
+
+        while(true) {
+            __m128 active = _mm_and_ps(_mm_cmple_ps(_mm_add_ps(x2, y2), four), _mm_cmplt_ps(it, max_it));
+            if(_mm_movemask_ps(active) == 0) break;
+
+            __m128 new_y = _mm_add_ps(_mm_mul_ps(_mm_add_ps(x, x), y), cy);
+            __m128 new_x = _mm_add_ps(_mm_sub_ps(x2, y2), cx);
+            y = _mm_or_ps(_mm_and_ps(active, new_y), _mm_andnot_ps(active, y));
+            x = _mm_or_ps(_mm_and_ps(active, new_x), _mm_andnot_ps(active, x));
+            x2 = _mm_mul_ps(x, x);
+            y2 = _mm_mul_ps(y, y);
+            it = _mm_add_ps(it, _mm_and_ps(active, one));
+            step ++;
+
+            if(tolerance > 0) {
+                __m128 close_x = _mm_cmple_ps(_mm_andnot_ps(sign, _mm_sub_ps(x, xold)), tol);
+                __m128 close_y = _mm_cmple_ps(_mm_andnot_ps(sign, _mm_sub_ps(y, yold)), tol);
+                __m128 periodic = _mm_and_ps(active, _mm_and_ps(close_x, close_y));
+                it = _mm_or_ps(_mm_and_ps(periodic, max_it), _mm_andnot_ps(periodic, it));
+                period = _mm_or_ps(_mm_and_ps(periodic, _mm_set1_ps(step - saved_at)), _mm_andnot_ps(periodic, period));
+                period_saved_at = _mm_or_ps(_mm_and_ps(periodic, _mm_set1_ps(saved_at)), _mm_andnot_ps(periodic, period_saved_at));
+                if((step & (step - 1)) == 0) {
+                    __m128 save = _mm_andnot_ps(periodic, active);
+                    xold = _mm_or_ps(_mm_and_ps(save, x), _mm_andnot_ps(save, xold));
+                    yold = _mm_or_ps(_mm_and_ps(save, y), _mm_andnot_ps(save, yold));
+                    saved_at = step;
+                }
+            }
+        }
+        _mm_storeu_si128((__m128i*)(iterations + k), _mm_cvttps_epi32(it));
+
+        float lx[4], ly[4], lxold[4], lyold[4], lperiod[4], lsaved_at[4];
+        _mm_storeu_ps(lx, x);
+        _mm_storeu_ps(ly, y);
+        _mm_storeu_ps(lxold, xold);
+        _mm_storeu_ps(lyold, yold);
+        _mm_storeu_ps(lperiod, period);
+        _mm_storeu_ps(lsaved_at, period_saved_at);
+        save_float_lanes(out, k, 4, lx, ly, lxold, lyold, lperiod, lsaved_at);
+    }
+    escape_scalar(x0, y0, k, n, max_iteration, tolerance, iterations, out);
+}
+
+// AVX2 version (8 points at a time)
+__attribute__((target("avx2")))
+static void escape_avx2(const float* x0, const float* y0, int n, int max_iteration, double tolerance, float tolerance_below, int* iterations, const simd_output& out) {
+    const __m256 four = _mm256_set1_ps(4.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 max_it = _mm256_set1_ps(max_iteration);
+    const __m256 tol = _mm256_set1_ps(tolerance_below);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+
+    int k = 0;
+    for(; k + 8 <= n; k += 8) {
+        __m256 cx = _mm256_loadu_ps(x0 + k);
+        __m256 cy = _mm256_loadu_ps(y0 + k);
+        __m256 x = _mm256_setzero_ps();
+        __m256 y = _mm256_setzero_ps();
+        __m256 x2 = _mm256_setzero_ps();
+        __m256 y2 = _mm256_setzero_ps();
+        __m256 it = _mm256_setzero_ps();
+        __m256 xold = _mm256_setzero_ps();
+        __m256 yold = _mm256_setzero_ps();
+        __m256 period = _mm256_setzero_ps();
+        __m256 period_saved_at = _mm256_setzero_ps();
+        int step = 0;
+        int saved_at = 0;
+
+        while(true) {
+            __m256 small = _mm256_cmp_ps(_mm256_add_ps(x2, y2), four, _CMP_LE_OQ);
+            __m256 active = _mm256_and_ps(small, _mm256_cmp_ps(it, max_it, _CMP_LT_OQ));
+            if(_mm256_movemask_ps(active) == 0) break;
+
+            __m256 new_y = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(x, x), y), cy);
+            __m256 new_x = _mm256_add_ps(_mm256_sub_ps(x2, y2), cx);
+            y = _mm256_blendv_ps(y, new_y, active);
+            x = _mm256_blendv_ps(x, new_x, active);
+            x2 = _mm256_mul_ps(x, x);
+            y2 = _mm256_mul_ps(y, y);
+            it = _mm256_add_ps(it, _mm256_and_ps(active, one));
+            step ++;
+
+            if(tolerance > 0) {
+                __m256 close_x = _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(x, xold)), tol, _CMP_LE_OQ);
+                __m256 close_y = _mm256_cmp_ps(_mm256_andnot_ps(sign, _mm256_sub_ps(y, yold)), tol, _CMP_LE_OQ);
+                __m256 periodic = _mm256_and_ps(active, _mm256_and_ps(close_x, close_y));
+                it = _mm256_blendv_ps(it, max_it, periodic);
+                period = _mm256_blendv_ps(period, _mm256_set1_ps(step - saved_at), periodic);
+                period_saved_at = _mm256_blendv_ps(period_saved_at, _mm256_set1_ps(saved_at), periodic);
+                if((step & (step - 1)) == 0) {
+                    __m256 save = _mm256_andnot_ps(periodic, active);
+                    xold = _mm256_blendv_ps(xold, x, save);
+                    yold = _mm256_blendv_ps(yold, y, save);
+                    saved_at = step;
+                }
+            }
+        }
+        _mm256_storeu_si256((__m256i*)(iterations + k), _mm256_cvttps_epi32(it));
+
+        float lx[8], ly[8], lxold[8], lyold[8], lperiod[8], lsaved_at[8];
+        _mm256_storeu_ps(lx, x);
+        _mm256_storeu_ps(ly, y);
+        _mm256_storeu_ps(lxold, xold);
+        _mm256_storeu_ps(lyold, yold);
+        _mm256_storeu_ps(lperiod, period);
+        _mm256_storeu_ps(lsaved_at, period_saved_at);
+        save_float_lanes(out, k, 8, lx, ly, lxold, lyold, lperiod, lsaved_at);
+    }
+    // Upper halves of the vector registers are cleared before going back to code without AVX instructions (which
+    // would otherwise be slowed down by every transition, e.g. a continuous coloring rendering after this one)
+    _mm256_zeroupper();
+    escape_scalar(x0, y0, k, n, max_iteration, tolerance, iterations, out);
+}
+
+// AVX-512 version (16 points at a time)
+__attribute__((target("avx512f")))
+static void escape_avx512(const float* x0, const float* y0, int n, int max_iteration, double tolerance, float tolerance_below, int* iterations, const simd_output& out) {
+    const __m512 four = _mm512_set1_ps(4.0f);
+    const __m512 one = _mm512_set1_ps(1.0f);
+    const __m512 max_it = _mm512_set1_ps(max_iteration);
+    const __m512 tol = _mm512_set1_ps(tolerance_below);
+
+    int k = 0;
+    for(; k + 16 <= n; k += 16) {
+        __m512 cx = _mm512_loadu_ps(x0 + k);
+        __m512 cy = _mm512_loadu_ps(y0 + k);
+        __m512 x = _mm512_setzero_ps();
+        __m512 y = _mm512_setzero_ps();
+        __m512 x2 = _mm512_setzero_ps();
+        __m512 y2 = _mm512_setzero_ps();
+        __m512 it = _mm512_setzero_ps();
+        __m512 xold = _mm512_setzero_ps();
+        __m512 yold = _mm512_setzero_ps();
+        __m512 period = _mm512_setzero_ps();
+        __m512 period_saved_at = _mm512_setzero_ps();
+        int step = 0;
+        int saved_at = 0;
+
+        while(true) {
+            __mmask16 active = _mm512_cmp_ps_mask(_mm512_add_ps(x2, y2), four, _CMP_LE_OQ);
+            active &= _mm512_cmp_ps_mask(it, max_it, _CMP_LT_OQ);
+            if(active == 0) break;
+
+            __m512 new_y = _mm512_add_ps(_mm512_mul_round_ps(_mm512_add_ps(x, x), y, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC), cy);
+            __m512 new_x = _mm512_add_ps(_mm512_sub_ps(x2, y2), cx);
+            y = _mm512_mask_mov_ps(y, active, new_y);
+            x = _mm512_mask_mov_ps(x, active, new_x);
+            x2 = _mm512_mul_ps(x, x);
+            y2 = _mm512_mul_ps(y, y);
+            it = _mm512_mask_add_ps(it, active, it, one);
+            step ++;
+
+            if(tolerance > 0) {
+                __mmask16 periodic = active & _mm512_cmp_ps_mask(_mm512_abs_ps(_mm512_sub_ps(x, xold)), tol, _CMP_LE_OQ);
+                periodic &= _mm512_cmp_ps_mask(_mm512_abs_ps(_mm512_sub_ps(y, yold)), tol, _CMP_LE_OQ);
+                it = _mm512_mask_mov_ps(it, periodic, max_it);
+                period = _mm512_mask_mov_ps(period, periodic, _mm512_set1_ps(step - saved_at));
+                period_saved_at = _mm512_mask_mov_ps(period_saved_at, periodic, _mm512_set1_ps(saved_at));
+                if((step & (step - 1)) == 0) {
+                    __mmask16 save = active & ~periodic;
+                    xold = _mm512_mask_mov_ps(xold, save, x);
+                    yold = _mm512_mask_mov_ps(yold, save, y);
+                    saved_at = step;
+                }
+            }
+        }
+        _mm512_storeu_si512((void*)(iterations + k), _mm512_cvttps_epi32(it));
+
+        float lx[16], ly[16], lxold[16], lyold[16], lperiod[16], lsaved_at[16];
+        _mm512_storeu_ps(lx, x);
+        _mm512_storeu_ps(ly, y);
+        _mm512_storeu_ps(lxold, xold);
+        _mm512_storeu_ps(lyold, yold);
+        _mm512_storeu_ps(lperiod, period);
+        _mm512_storeu_ps(lsaved_at, period_saved_at);
+        save_float_lanes(out, k, 16, lx, ly, lxold, lyold, lperiod, lsaved_at);
+    }
+    // Upper halves of the vector registers are cleared before going back to code without AVX instructions (which
+    // would otherwise be slowed down by every transition, e.g. a continuous coloring rendering after this one)
+    _mm256_zeroupper();
+    escape_scalar(x0, y0, k, n, max_iteration, tolerance, iterations, out);
+}
+
+#endif // MANDELBROT_X86_SIMD
+
+simd_level detect_simd_level() {
+#ifdef MANDELBROT_X86_SIMD
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx512f")) return SIMD_AVX512;
+    if(__builtin_cpu_supports("avx2")) return SIMD_AVX2;
+    if(__builtin_cpu_supports("sse2")) return SIMD_SSE2;
+#endif
+    return SIMD_SCALAR;
+}
+
+const char* simd_level_name(simd_level level) {
+    if(level == SIMD_AVX512) return "AVX-512";
+    if(level == SIMD_AVX2) return "AVX2";
+    if(level == SIMD_SSE2) return "SSE2";
+    return "Scalar";
+}
+
+int simd_lanes(simd_level level, bool floats) {
+    int lanes = 1;
+    if(level == SIMD_AVX512) lanes = 8;
+    else if(level == SIMD_AVX2) lanes = 4;
+    else if(level == SIMD_SSE2) lanes = 2;
+    // A vector holds twice as many floats as doubles
+    if(floats && level != SIMD_SCALAR) lanes *= 2;
+    return lanes;
+}
+
+void simd_escape_time(simd_level level, const double* x0, const double* y0, int n, int max_iteration, double tolerance, int* iterations, const simd_output& out) {
+#ifdef MANDELBROT_X86_SIMD
+    if(level == SIMD_AVX512) {
+        escape_avx512(x0, y0, n, max_iteration, tolerance, iterations, out);
+        return;
+    }
+    if(level == SIMD_AVX2) {
+        escape_avx2(x0, y0, n, max_iteration, tolerance, iterations, out);
+        return;
+    }
+    if(level == SIMD_SSE2) {
+        escape_sse2(x0, y0, n, max_iteration, tolerance, iterations, out);
+        return;
+    }
+#endif
+    escape_scalar(x0, y0, 0, n, max_iteration, tolerance, iterations, out);
+}
+
+void simd_escape_time(simd_level level, const float* x0, const float* y0, int n, int max_iteration, double tolerance, int* iterations, const simd_output& out) {
+#ifdef MANDELBROT_X86_SIMD
+    // Largest float below the tolerance (a float distance d is below the tolerance if and only if d <= tolerance_below)
+    float tolerance_below = (float)tolerance;
+    if(tolerance_below >= tolerance) tolerance_below = nextafterf(tolerance_below, 0.0f);
+
+    if(level == SIMD_AVX512) {
+        escape_avx512(x0, y0, n, max_iteration, tolerance, tolerance_below, iterations, out);
+        return;
+    }
+    if(level == SIMD_AVX2) {
+        escape_avx2(x0, y0, n, max_iteration, tolerance, tolerance_below, iterations, out);
+        return;
+    }
+    if(level == SIMD_SSE2) {
+        escape_sse2(x0, y0, n, max_iteration, tolerance, tolerance_below, iterations, out);
+        return;
+    }
+#endif
+    escape_scalar(x0, y0, 0, n, max_iteration, tolerance, iterations, out);
+}
@@ -0,0 +1,41 @@
+#ifndef __SIMD_H__
+#define __SIMD_H__
+
+// Instruction sets which can be used by the vectorized escape time algorithm
+// SIMD_SCALAR works on 1 point at a time, SSE2 on 2, AVX2 on 4 and AVX-512 on 8 points at a time (twice as many in floats)
+enum simd_level { SIMD_SCALAR, SIMD_SSE2, SIMD_AVX2, SIMD_AVX512 };
+
+// Optional outputs of the vectorized escape time algorithm (any of the pointers may be null)
+struct simd_output {
+    // Last value of z = x + iy (so that the orbit can be continued later)
+    double* x;
+    double* y;
+    // Value of z saved by cycle detection (so that cycle detection can also be continued later)
+    double* xold;
+    double* yold;
+    // Period found by cycle detection (0 if the orbit was not found to be periodic)
+    int* periods;
+    // Iteration at which the value of z a periodic orbit came back to was saved (0 if it was not found to be periodic),
+    // so that the iterations it did are known
+    int* saved_at;
+    // Constructor (all outputs null)
+    simd_output();
+};
+
+// Function to find the best instruction set supported by the processor (checked at runtime)
+simd_level detect_simd_level();
+// Function to return the name of an instruction set (used while printing runtimes)
+const char* simd_level_name(simd_level level);
+// Function to return number of points iterated together by an instruction set (in doubles, or in floats if floats is true)
+int simd_lanes(simd_level level, bool floats = false);
+
+// Vectorized version of the optimized escape time algorithm
+// For k in [0, n), iterations[k] is set to the number of iterations required by c = x0[k] + iy0[k] to escape
+// (or max_iteration if it does not escape), exactly as in the scalar optimized escape time algorithm
+// If tolerance > 0, then Brent's cycle detection is also done (exactly as in the scalar algorithms), and points
+// found to be periodic get max_iteration
+void simd_escape_time(simd_level level, const double* x0, const double* y0, int n, int max_iteration, double tolerance, int* iterations, const simd_output& out = simd_output());
+// Same algorithm in floats, iterating twice as many points together (exactly as the optimized escape time algorithm
+// in floats; max_iteration must be below 2^24)
+void simd_escape_time(simd_level level, const float* x0, const float* y0, int n, int max_iteration, double tolerance, int* iterations, const simd_output& out = simd_output());
+#endif // __SIMD_H__
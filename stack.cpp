@@ -2,47 +2,158 @@
 #include <cstddef>
 
 pixels_data::pixels_data() {
-    // Initially no previous neighbor
-    prev = NULL;
+    // Initially no previous neighbor (prev is null), and no limits
+    lim_l = lim_r = lim_t = lim_b = 0;
+    span_x = span_y = 0;
+    zoom = 1;
+    run_length = true;
+}
+
+// Function to pack a color into 4 bytes (red in the lowest byte), and to unpack it
+static inline sf::Uint32 pack_color(const sf::Color& c) {
+    return c.r | (c.g << 8) | (c.b << 16) | ((sf::Uint32)c.a << 24);
+}
+
+static inline sf::Color unpack_color(sf::Uint32 color) {
+    return sf::Color(color & 255, (color >> 8) & 255, (color >> 16) & 255, color >> 24);
+}
+
+void pixels_data::store(const vector<sf::Color>& framebuffer) {
+    runs.clear();
+    vector<sf::Uint32>().swap(raw);
+    run_length = true;
+
+    // Runs take 8 bytes and plain colors 4, so encoding stops as soon as there are more runs than half the points
+    size_t max_runs = framebuffer.size() / 2;
+    for(size_t k = 0; k < framebuffer.size(); k ++) {
+        sf::Uint32 color = pack_color(framebuffer[k]);
+
+        // Extend the last run if it has the same color, else start a new run
+        if(!runs.empty() && runs.back().color == color) runs.back().length ++;
+        else {
+            if(runs.size() == max_runs) {
+                run_length = false;
+                break;
+            }
+            color_run run;
+            run.color = color;
+            run.length = 1;
+            runs.push_back(run);
+        }
+    }
+
+    if(run_length) {
+        // Release the memory which was reserved but not used
+        runs.shrink_to_fit();
+        return;
+    }
+    // Noisy plot, so the colors are saved as they are
+    vector<color_run>().swap(runs);
+    raw.resize(framebuffer.size());
+    for(size_t k = 0; k < framebuffer.size(); k ++) {
+        raw[k] = pack_color(framebuffer[k]);
+    }
+}
+
+bool pixels_data::restore(vector<sf::Color>& framebuffer) const {
+    if(!run_length) {
+        if(raw.empty()) return false;
+        for(size_t k = 0; k < raw.size(); k ++) {
+            framebuffer[k] = unpack_color(raw[k]);
+        }
+        return true;
+    }
+    if(runs.empty()) return false;
+
+    size_t k = 0;
+    for(size_t r = 0; r < runs.size(); r ++) {
+        // Unpacking the color of the run
+        sf::Color c = unpack_color(runs[r].color);
+        for(sf::Uint32 l = 0; l < runs[r].length; l ++) {
+            framebuffer[k ++] = c;
+        }
+    }
+    return true;
+}
+
+size_t pixels_data::bytes() const {
+    return runs.capacity() * sizeof(color_run) + raw.capacity() * sizeof(sf::Uint32);
+}
+
+void pixels_data::evict() {
+    vector<color_run>().swap(runs);
+    vector<sf::Uint32>().swap(raw);
 }
 
 stack_pixels::stack_pixels() {
     // When stack is empty, topmost element is null
-    top = NULL;
-    size = 0;
+    count = 0;
+    memory_budget = 64 << 20;
+    memory_used = 0;
 }
 
-void stack_pixels::push(pixels_data* elem) {
-    // If stack is empty, then add elem to the stack, and put top at elem
-    if(size == 0) {
-        top = elem;
+stack_pixels::~stack_pixels() {
+    // Elements are freed one by one from the top, instead of recursively through the prev pointers
+    while(top) {
+        top = move(top -> prev);
     }
+}
 
-    // Else if there is already an element in the stack, then the repvious element of elem is the current top
-    // Now update top with the value of elem
-    else {
-        elem -> prev = top;
-        top = elem;
+void stack_pixels::set_memory_budget(size_t memory_budget) {
+    this -> memory_budget = memory_budget;
+    evict();
+}
+
+void stack_pixels::evict() {
+    if(memory_used <= memory_budget) return;
+
+    // Elements are linked from top to bottom, so first list them to be able to go from the oldest one upwards
+    vector<pixels_data*> elems;
+    for(pixels_data* elem = top.get(); elem != NULL; elem = elem -> prev.get()) {
+        elems.push_back(elem);
     }
 
-    // Increase number of elements in stack by 1
-    size ++;
+    // Oldest renderings lose their colors first (their limits and zoom are kept, so they can be rendered again)
+    for(size_t k = elems.size() - 1; k > 0 && memory_used > memory_budget; k --) {
+        memory_used -= elems[k] -> bytes();
+        elems[k] -> evict();
+    }
 }
 
-// pop is run under the assumption that stack has at least one element
-// This assumption is ensured whenever the function pop is called
-pixels_data stack_pixels::pop() {
-    // If there is only one element in the stack, then return this element and make top null
-    if(size == 1) {
-        pixels_data temp = *top;
-        top = NULL;
-        size --;
-        return temp;
-    }
+void stack_pixels::push(unique_ptr<pixels_data> elem) {
+    // Account for the memory of the new rendering
+    memory_used += elem -> bytes();
+
+    // The previous element of elem is the current top (null if stack is empty)
+    // Now update top with the value of elem
+    elem -> prev = move(top);
+    top = move(elem);
+
+    // Increase number of elements in stack by 1, and evict old renderings if the budget is exceeded
+    count ++;
+    evict();
+}
+
+unique_ptr<pixels_data> stack_pixels::pop() {
+    if(!top) return unique_ptr<pixels_data>();
+
+    // Make top point to its previous element, and decrease size by 1
+    // Return the original top element (detached from the rest of the stack)
+    unique_ptr<pixels_data> elem = move(top);
+    top = move(elem -> prev);
+    memory_used -= elem -> bytes();
+    count --;
+    return elem;
+}
+
+const pixels_data* stack_pixels::peek() const {
+    return top.get();
+}
+
+int stack_pixels::size() const {
+    return count;
+}
 
-    // Else decrease size by 1, and make top point to its previous element
-    // Return contents of original top element
-    size --;
-    top = top -> prev;
-    return *top;
+size_t stack_pixels::bytes() const {
+    return memory_used + count * sizeof(pixels_data);
 }
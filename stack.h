@@ -1,11 +1,31 @@
 #ifndef __STACK_H__
 #define __STACK_H__
 #include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "bignum.h"
+using namespace std;
+
+// Run of consecutive points having the same color
+struct color_run {
+    // Color packed as RGBA8 (red in the lowest byte)
+    sf::Uint32 color;
+    // Number of points in the run
+    sf::Uint32 length;
+};
 
 // Structure containing crucial data for a rendering of the Mandelbrot Set
 struct pixels_data {
-    // Array of points, containing color of each point in the window
-    sf::VertexArray points;
+    // Colors of the points in the window, run-length encoded (escape bands have many equal neighbouring colors)
+    vector<color_run> runs;
+    // Colors of the points in the window packed as RGBA8, used instead of runs for noisy plots (a run takes 8 bytes,
+    // so with more runs than half the points the encoded colors would be larger than the plain ones)
+    vector<sf::Uint32> raw;
+    // Whether the colors are saved in runs (else in raw)
+    // Both are empty if the colors were evicted to stay in the memory budget of the stack (then the plot must be
+    // rendered again)
+    bool run_length;
     // Left limit of the Mandelbrot Set (min x)
     double lim_l;
     // Right limit of the Mandelbrot Set (max x)
@@ -16,28 +36,59 @@ struct pixels_data {
     double lim_b;
     // Zoom factor of the given rendering
     long long zoom;
-    // Pointer to previous element of the stack
-    pixels_data* prev;
+    // Center of the view (in high precision) and its width and height
+    big_number center_x;
+    big_number center_y;
+    double span_x;
+    double span_y;
+    // Previous element of the stack (owned by this element, so the whole stack is freed through its top)
+    unique_ptr<pixels_data> prev;
     // Constructor
     pixels_data();
+    // Function to save the colors of a framebuffer (run-length encoded, unless that takes more memory)
+    void store(const vector<sf::Color>& framebuffer);
+    // Function to write the saved colors back to a framebuffer of the same size (returns false if colors were evicted)
+    bool restore(vector<sf::Color>& framebuffer) const;
+    // Memory used by the saved colors (in bytes)
+    size_t bytes() const;
+    // Function to drop the saved colors
+    void evict();
 };
 
 // Stack containing rendering of the Mandelbrot Set at different zoom levels
 // Implemented as a linked list, with top-to-bottom pointers
+// The stack owns its elements: they are moved in by push, and freed by pop (unless the caller keeps the popped element)
 class stack_pixels {
 
 private:
     // Topmost element of stack
-    pixels_data* top;
+    unique_ptr<pixels_data> top;
     // Number of renderings present in the stack, initially 0
-    int size;
+    int count;
+    // Memory which can be used by the colors of all renderings together (in bytes)
+    size_t memory_budget;
+    // Memory currently used by the colors of all renderings (in bytes)
+    size_t memory_used;
+    // Function to evict colors of the oldest renderings till memory used is within the budget
+    // (the topmost rendering is never evicted)
+    void evict();
 
 public:
-    // Constructor
+    // Constructor (default memory budget is 64 MB)
     stack_pixels();
+    // Destructor (frees all elements)
+    ~stack_pixels();
+    // Function to change the memory budget (in bytes)
+    void set_memory_budget(size_t memory_budget);
     // Pushing a new element (of rendering) at the top of the stack
-    void push(pixels_data* elem);
-    // Removing and returning the topmost element of the stack
-    pixels_data pop();
+    void push(unique_ptr<pixels_data> elem);
+    // Removing and returning the topmost element of the stack (null if the stack is empty)
+    unique_ptr<pixels_data> pop();
+    // Returning the topmost element of the stack without removing it (null if the stack is empty)
+    const pixels_data* peek() const;
+    // Number of renderings present in the stack
+    int size() const;
+    // Memory used by the stack, i.e. by the colors and the other data of all renderings (in bytes)
+    size_t bytes() const;
 };
 #endif // __STACK_H__
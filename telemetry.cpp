@@ -0,0 +1,94 @@
+#include "telemetry.h"
+#include <cmath>
+
+const char* telemetry_phase_name(telemetry_phase phase) {
+    if(phase == PHASE_SETUP) return "setup";
+    if(phase == PHASE_ORBITS) return "orbits";
+    if(phase == PHASE_HISTOGRAM) return "histogram";
+    if(phase == PHASE_COLORING) return "coloring";
+    return "stack push";
+}
+
+telemetry_report::telemetry_report() {
+    enabled = false;
+    iterations = escaped = cycles = bailed = 0;
+    interior = reused = filled = 0;
+    for(int k = 0; k < TELEMETRY_PHASES; k ++) phase_seconds[k] = 0;
+    total_seconds = 0;
+    tiles = 0;
+    mean_tile_seconds = slowest_tile_seconds = 0;
+    slowest_tile_x = slowest_tile_y = 0;
+}
+
+tile_counters::tile_counters() {
+    iterations = escaped = cycles = bailed = 0;
+}
+
+render_telemetry::render_telemetry() {
+    iterations = escaped = cycles = bailed = 0;
+    for(int k = 0; k < TELEMETRY_PHASES; k ++) phase_seconds[k] = 0;
+    total_seconds = 0;
+    active = false;
+    timing_tiles = false;
+    tiles_x = 0;
+}
+
+void render_telemetry::start_rendering(int points, int tiles_x, int tiles_y) {
+    iterations = escaped = cycles = bailed = 0;
+    for(int k = 0; k < TELEMETRY_PHASES; k ++) phase_seconds[k] = 0;
+    total_seconds = 0;
+    this -> tiles_x = tiles_x;
+    tile_seconds.assign(tiles_x * tiles_y, 0);
+    point_cost.assign(points, 0);
+    start = chrono::steady_clock::now();
+    active = true;
+    timing_tiles = true;
+}
+
+void render_telemetry::add(const tile_counters& counters) {
+    iterations += counters.iterations;
+    escaped += counters.escaped;
+    cycles += counters.cycles;
+    bailed += counters.bailed;
+}
+
+void render_telemetry::finish() {
+    if(!active) return;
+    total_seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    double others = 0;
+    for(int k = 0; k < TELEMETRY_PHASES; k ++) {
+        if(k != PHASE_ORBITS) others += phase_seconds[k];
+    }
+    phase_seconds[PHASE_ORBITS] = max(0.0, total_seconds - others);
+    active = false;
+    timing_tiles = false;
+}
+
+phase_timer::phase_timer(render_telemetry& telemetry, telemetry_phase phase, bool finishes) : telemetry(telemetry) {
+    this -> phase = phase;
+    this -> finishes = finishes;
+    start = chrono::steady_clock::now();
+    was_timing_tiles = telemetry.timing_tiles;
+    telemetry.timing_tiles = false;
+}
+
+phase_timer::~phase_timer() {
+    // Time outside a rendering (e.g. recoloring after the palette is changed) is not part of any rendering
+    if(telemetry.active) telemetry.phase_seconds[phase] += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    telemetry.timing_tiles = was_timing_tiles;
+    if(finishes) telemetry.finish();
+}
+
+void heatmap_colors(const int* values, int count, int max_value, sf::Color* colors) {
+    // Colors at 0, 1/4, 1/2, 3/4 and 1 of the scale, with linear interpolation between them
+    static const int stops[5][3] = {{0, 0, 0}, {0, 0, 255}, {255, 0, 0}, {255, 255, 0}, {255, 255, 255}};
+    double scale = 1 / log(1.0 + max(max_value, 1));
+    for(int k = 0; k < count; k ++) {
+        double t = min(1.0, log(1.0 + max(values[k], 0)) * scale) * 4;
+        int stop = min((int)t, 3);
+        double f = t - stop;
+        colors[k] = sf::Color((sf::Uint8)(stops[stop][0] + (stops[stop + 1][0] - stops[stop][0]) * f),
+                              (sf::Uint8)(stops[stop][1] + (stops[stop + 1][1] - stops[stop][1]) * f),
+                              (sf::Uint8)(stops[stop][2] + (stops[stop + 1][2] - stops[stop][2]) * f));
+    }
+}
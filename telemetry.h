@@ -0,0 +1,158 @@
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+#include <SFML/Graphics.hpp>
+#include <atomic>
+#include <chrono>
+#include <vector>
+using namespace std;
+
+// Telemetry of renderings: iterations done, how points ended (escaped, found periodic, or bailed out at max_iteration),
+// time of every phase of a rendering, time of every tile, and iterations done by every point
+// It is only compiled in when MANDELBROT_TELEMETRY is defined; otherwise all TELEMETRY_ macros are empty, so the
+// algorithms are exactly the same as without it (MandelbrotSet::get_telemetry then reports it as disabled)
+
+// Phases of a rendering: setup (reprojection and tile cache), orbits (iterating the points), histogram (of histogram
+// coloring), coloring (recolor and previews), and stack push (saving the rendering to the stack and the tile cache)
+enum telemetry_phase { PHASE_SETUP, PHASE_ORBITS, PHASE_HISTOGRAM, PHASE_COLORING, PHASE_STACK_PUSH };
+const int TELEMETRY_PHASES = 5;
+
+// Function to return the name of a phase (used in the overlay)
+const char* telemetry_phase_name(telemetry_phase phase);
+
+// Summary of the telemetry of the last rendering (a copy, which can be passed to other threads)
+struct telemetry_report {
+    // Whether telemetry is compiled in (if not, only the counters kept anyway are set: interior, reused and filled)
+    bool enabled;
+    // Iterations done by all points, and number of points which escaped, were found periodic by cycle detection, and
+    // reached max_iteration without either (bailed out)
+    long long iterations;
+    long long escaped;
+    long long cycles;
+    long long bailed;
+    // Points skipped by the interior check, reused from the previous rendering or the tile cache, and filled by the
+    // subdivision algorithm (none of them is iterated)
+    long long interior;
+    long long reused;
+    long long filled;
+    // Time of every phase and of the whole rendering (in seconds)
+    double phase_seconds[TELEMETRY_PHASES];
+    double total_seconds;
+    // Number of tiles timed, their mean and largest time (in seconds), and the position of the slowest one (in tiles)
+    int tiles;
+    double mean_tile_seconds;
+    double slowest_tile_seconds;
+    int slowest_tile_x;
+    int slowest_tile_y;
+    // Constructor (all 0, disabled)
+    telemetry_report();
+};
+
+// Counters of the points of a tile (or rectangle), kept by the thread rendering it and added to the telemetry of the
+// rendering once the tile is done (so the threads do not share counters while iterating)
+struct tile_counters {
+    long long iterations;
+    long long escaped;
+    long long cycles;
+    long long bailed;
+    tile_counters();
+    // Function to count a point iterated from iteration start till iteration (period > 0 if cycle detection found it
+    // periodic, saved_at is then the iteration at which the value of z it came back to was saved)
+    // Returns the number of iterations done by the point
+    inline int point(int start, int iteration, int period, int saved_at, int max_iteration) {
+        int done;
+        if(iteration < max_iteration) {
+            escaped ++;
+            done = iteration - start;
+        }
+        else if(period > 0) {
+            cycles ++;
+            done = saved_at + period - start;
+        }
+        else {
+            bailed ++;
+            done = max_iteration - start;
+        }
+        iterations += done;
+        return done;
+    }
+};
+
+// Telemetry of the rendering in progress (part of the Set)
+struct render_telemetry {
+    // Counters of all tiles done so far
+    atomic<long long> iterations;
+    atomic<long long> escaped;
+    atomic<long long> cycles;
+    atomic<long long> bailed;
+    // Time of every phase (in seconds), start of the rendering, and time of the whole rendering once it is finished
+    double phase_seconds[TELEMETRY_PHASES];
+    chrono::steady_clock::time_point start;
+    double total_seconds;
+    // Whether a rendering is in progress (phases are only timed during renderings), and whether the tiles rendered now
+    // are timed (they are not while coloring, which goes through the same tiles)
+    bool active;
+    bool timing_tiles;
+    // Time spent on every tile by the algorithm (in seconds), and the number of tiles along x
+    vector<double> tile_seconds;
+    int tiles_x;
+    // Iterations done by every point (0 for points which were not iterated), row by row
+    vector<int> point_cost;
+
+    render_telemetry();
+    // Function to start a rendering of a number of points, in tiles_x * tiles_y tiles
+    void start_rendering(int points, int tiles_x, int tiles_y);
+    // Function to add the counters of a tile
+    void add(const tile_counters& counters);
+    // Function to finish the rendering: the orbit phase is the time not spent in the other phases
+    void finish();
+};
+
+// Timer adding the time from its construction to its destruction to a phase of the rendering in progress (and then
+// finishing the rendering, if finishes is true)
+// Tiles rendered meanwhile are not timed as tiles of the algorithm
+class phase_timer {
+
+private:
+    render_telemetry& telemetry;
+    telemetry_phase phase;
+    chrono::steady_clock::time_point start;
+    bool was_timing_tiles;
+    bool finishes;
+
+public:
+    phase_timer(render_telemetry& telemetry, telemetry_phase phase, bool finishes = false);
+    ~phase_timer();
+};
+
+// Function to color values (iterations done by points) from black through blue, red and yellow to white, on a
+// logarithmic scale up to max_value, so that points of all costs can be told apart
+void heatmap_colors(const int* values, int count, int max_value, sf::Color* colors);
+
+#ifdef MANDELBROT_TELEMETRY
+// Macros used by MandelbrotSet (telemetry is its member)
+#define TELEMETRY_START(points, tiles_x, tiles_y) telemetry.start_rendering(points, tiles_x, tiles_y)
+#define TELEMETRY_FINISH() telemetry.finish()
+#define TELEMETRY_PHASE(phase) phase_timer telemetry_timer(telemetry, phase)
+#define TELEMETRY_LAST_PHASE(phase) phase_timer telemetry_timer(telemetry, phase, true)
+#define TELEMETRY_COUNTERS(counters) tile_counters counters
+#define TELEMETRY_POINT(counters, k, start, iteration, period, saved_at) \
+    telemetry.point_cost[k] = (counters).point(start, iteration, period, saved_at, max_iteration)
+#define TELEMETRY_ADD(counters) telemetry.add(counters)
+#define TELEMETRY_TILE_BEGIN() auto telemetry_tile_start = chrono::steady_clock::now()
+// (TELEMETRY_TILE_END is a single statement, so that an else after it is not taken by its if)
+#define TELEMETRY_TILE_END(tile) do { \
+    if(telemetry.timing_tiles) \
+        telemetry.tile_seconds[tile] += chrono::duration<double>(chrono::steady_clock::now() - telemetry_tile_start).count(); \
+} while(0)
+#else
+#define TELEMETRY_START(points, tiles_x, tiles_y)
+#define TELEMETRY_FINISH()
+#define TELEMETRY_PHASE(phase)
+#define TELEMETRY_LAST_PHASE(phase)
+#define TELEMETRY_COUNTERS(counters)
+#define TELEMETRY_POINT(counters, k, start, iteration, period, saved_at)
+#define TELEMETRY_ADD(counters)
+#define TELEMETRY_TILE_BEGIN()
+#define TELEMETRY_TILE_END(tile) do { } while(0)
+#endif
+#endif // __TELEMETRY_H__
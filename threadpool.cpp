@@ -0,0 +1,169 @@
+#include "threadpool.h"
+using namespace std;
+
+// Pool the current thread works for, and its index in that pool (threads outside any pool use queue 0 of every pool)
+// The index is only valid in the pool it was set by, since pools may have different numbers of threads
+static thread_local thread_pool* current_pool = nullptr;
+static thread_local int current_index = 0;
+
+thread_pool::thread_pool(int threads) {
+    queued = 0;
+    next_queue = 0;
+    stopping = false;
+    start(threads);
+}
+
+thread_pool::~thread_pool() {
+    stop();
+}
+
+void thread_pool::start(int threads) {
+    // Default number of threads is the number of cores (hardware_concurrency may return 0 if unknown)
+    if(threads <= 0) threads = thread::hardware_concurrency();
+    if(threads <= 0) threads = 1;
+    this -> threads = threads;
+    stopping = false;
+
+    queues.clear();
+    for(int i = 0; i < threads; i ++) {
+        queues.push_back(unique_ptr<worker_queue>(new worker_queue));
+    }
+    // Queue 0 belongs to the calling thread, so workers get indices 1 to threads - 1
+    for(int i = 1; i < threads; i ++) {
+        workers.push_back(thread(&thread_pool::worker_loop, this, i));
+    }
+}
+
+void thread_pool::stop() {
+    {
+        lock_guard<mutex> guard(sleep_lock);
+        stopping = true;
+    }
+    wake_up.notify_all();
+    for(size_t i = 0; i < workers.size(); i ++) {
+        workers[i].join();
+    }
+    workers.clear();
+}
+
+void thread_pool::set_threads(int threads) {
+    stop();
+    start(threads);
+}
+
+int thread_pool::get_threads() {
+    return threads;
+}
+
+int thread_pool::own_index() {
+    return current_pool == this ? current_index : 0;
+}
+
+int thread_pool::thread_index() {
+    return own_index();
+}
+
+bool thread_pool::take_task(int index, pool_task& task) {
+    // First look for the most recently added task in own queue (it is most likely to be in the cache)
+    {
+        worker_queue& own = *queues[index];
+        lock_guard<mutex> guard(own.lock);
+        if(!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            queued --;
+            return true;
+        }
+    }
+
+    // Otherwise steal the oldest task from some other queue, starting from the next one
+    for(int k = 1; k < threads; k ++) {
+        worker_queue& other = *queues[(index + k) % threads];
+        lock_guard<mutex> guard(other.lock);
+        if(!other.tasks.empty()) {
+            task = other.tasks.front();
+            other.tasks.pop_front();
+            queued --;
+            return true;
+        }
+    }
+    return false;
+}
+
+void thread_pool::run_task(pool_task& task) {
+    task.fn();
+    // Release the function before marking the task as finished, since the group may be destroyed right after
+    task.fn = nullptr;
+    task_group* group = task.group;
+    lock_guard<mutex> guard(group -> lock);
+    if(-- group -> remaining == 0) group -> finished.notify_all();
+}
+
+void thread_pool::worker_loop(int index) {
+    current_pool = this;
+    current_index = index;
+    pool_task task;
+    while(true) {
+        if(take_task(index, task)) {
+            run_task(task);
+            continue;
+        }
+
+        // Nothing to do, so sleep till some task is submitted (or pool is stopped)
+        unique_lock<mutex> guard(sleep_lock);
+        wake_up.wait(guard, [this] { return stopping || queued > 0; });
+        if(stopping) return;
+    }
+}
+
+void thread_pool::submit(function<void()> fn, task_group* group) {
+    // Tasks submitted by a thread of the pool go to its own queue (so nested work stays local)
+    // Tasks from outside the pool are spread over all queues in round robin manner
+    int index = own_index();
+    if(index == 0) index = next_queue ++ % threads;
+
+    pool_task task;
+    task.fn = fn;
+    task.group = group;
+    {
+        lock_guard<mutex> guard(queues[index] -> lock);
+        queues[index] -> tasks.push_back(task);
+    }
+    {
+        lock_guard<mutex> guard(sleep_lock);
+        queued ++;
+    }
+    wake_up.notify_one();
+}
+
+void thread_pool::parallel_for(int n, const function<void(int)>& fn) {
+    if(n <= 0) return;
+
+    // With a single thread there is nothing to distribute
+    if(threads == 1) {
+        for(int k = 0; k < n; k ++) fn(k);
+        return;
+    }
+
+    task_group group;
+    group.remaining = n;
+    for(int k = 0; k < n; k ++) {
+        submit([&fn, k] { fn(k); }, &group);
+    }
+
+    // Calling thread works on tasks (its own first, then stolen ones) while there are any, and then sleeps till
+    // the threads still running tasks of the group have finished them
+    int index = own_index();
+    pool_task task;
+    while(group.remaining > 0) {
+        if(take_task(index, task)) {
+            run_task(task);
+            continue;
+        }
+        unique_lock<mutex> guard(group.lock);
+        group.finished.wait(guard, [&group] { return group.remaining == 0; });
+    }
+    // The last task may still be holding the lock after decrementing the counter, so wait for it to release the lock
+    // before the group is destroyed
+    lock_guard<mutex> guard(group.lock);
+}
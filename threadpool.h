@@ -0,0 +1,90 @@
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+// Group of tasks submitted by one parallel_for call
+// The thread which finishes the last task wakes up the caller, which sleeps once there is nothing left to take
+struct task_group {
+    // Number of unfinished tasks (only decremented while holding lock, so the caller may destroy the group as soon
+    // as it has seen 0 under the lock)
+    atomic<int> remaining;
+    mutex lock;
+    condition_variable finished;
+};
+
+// A unit of work in the pool, along with the group (parallel_for call) it belongs to
+struct pool_task {
+    // Function to be run
+    function<void()> fn;
+    // Group of this task (its counter is decremented once fn has run)
+    task_group* group;
+};
+
+// Work queue of a single thread of the pool
+// The owner thread takes tasks from the back, other (idle) threads steal from the front
+struct worker_queue {
+    deque<pool_task> tasks;
+    mutex lock;
+};
+
+// Work-stealing thread pool used to render the Mandelbrot Set in parallel
+// The thread calling parallel_for also works on the tasks, so a pool of n threads starts n - 1 workers
+class thread_pool {
+
+private:
+    // Total number of threads working on tasks (including the calling thread)
+    int threads;
+    // One queue for every thread, index 0 belongs to the calling thread
+    vector<unique_ptr<worker_queue> > queues;
+    // Worker threads (threads - 1 of them)
+    vector<thread> workers;
+    // Number of tasks submitted but not yet taken by any thread (lets idle workers sleep)
+    atomic<int> queued;
+    // Set when the pool is being destroyed or resized
+    bool stopping;
+    // Mutex and condition variable used to wake up sleeping workers
+    mutex sleep_lock;
+    condition_variable wake_up;
+    // Queue to which the next task from outside the pool is submitted (round robin)
+    atomic<unsigned> next_queue;
+
+    // Start and stop the worker threads
+    void start(int threads);
+    void stop();
+    // Loop run by worker thread with the given index
+    void worker_loop(int index);
+    // Index of the queue of the current thread (0 for threads outside this pool, even if they belong to another one)
+    int own_index();
+    // Take a task from own queue, or steal one from another queue; returns false if all queues are empty
+    bool take_task(int index, pool_task& task);
+    // Run a task and mark it as finished in its group
+    void run_task(pool_task& task);
+    // Add a task to some queue (own queue if called from a thread of the pool)
+    void submit(function<void()> fn, task_group* group);
+
+public:
+    // Constructor (threads <= 0 means one thread per core)
+    thread_pool(int threads = 0);
+    // Destructor (joins all workers)
+    ~thread_pool();
+    // Function to change the number of threads (threads <= 0 means one thread per core)
+    void set_threads(int threads);
+    // Function to return number of threads
+    int get_threads();
+    // Index of the current thread in the pool, in [0, threads) (0 for threads outside the pool)
+    int thread_index();
+    // Run fn(0), fn(1), ..., fn(n - 1) on the threads of the pool and wait for all of them to finish
+    // The calling thread works on tasks too, and sleeps once no task is left to take till the last one is finished
+    // May be called from inside a task: the calling thread then also takes queued tasks (of any group) while there are
+    // any, and then sleeps till its own tasks are finished
+    void parallel_for(int n, const function<void(int)>& fn);
+};
+#endif // __THREADPOOL_H__
@@ -0,0 +1,103 @@
+#include "tile_cache.h"
+#include <cstring>
+
+bool tile_key::operator==(const tile_key& key) const {
+    return spacing_x == key.spacing_x && spacing_y == key.spacing_y && origin == key.origin
+        && max_iteration == key.max_iteration && kernel == key.kernel;
+}
+
+size_t tile_key_hash::operator()(const tile_key& key) const {
+    // Combining all fields into the hash of the position
+    unsigned long long h = key.origin;
+    unsigned long long fields[4];
+    memcpy(&fields[0], &key.spacing_x, sizeof(double));
+    memcpy(&fields[1], &key.spacing_y, sizeof(double));
+    fields[2] = key.max_iteration;
+    fields[3] = key.kernel;
+    for(int k = 0; k < 4; k ++) {
+        h = (h ^ fields[k]) * 1099511628211ULL;
+    }
+    return (size_t)(h ^ (h >> 32));
+}
+
+size_t tile_data::bytes() const {
+    return (x.capacity() + y.capacity()) * sizeof(float) + iterations.capacity() * sizeof(int)
+        + fractions.capacity() * sizeof(float) + periods.capacity() * sizeof(int);
+}
+
+tile_cache::tile_cache() {
+    memory_budget = 64 << 20;
+    memory_used = 0;
+    hits = 0;
+    misses = 0;
+}
+
+void tile_cache::set_memory_budget(size_t memory_budget) {
+    this -> memory_budget = memory_budget;
+    evict();
+}
+
+void tile_cache::evict() {
+    // Least recently used tiles are at the back of the list
+    while(memory_used > memory_budget && tiles.size() > 1) {
+        memory_used -= tiles.back().second.bytes();
+        index.erase(tiles.back().first);
+        tiles.pop_back();
+    }
+}
+
+const tile_data* tile_cache::find(const tile_key& key) {
+    auto found = index.find(key);
+    if(found == index.end()) return NULL;
+    // Moving the tile to the front of the list (iterators of the list stay valid)
+    tiles.splice(tiles.begin(), tiles, found -> second);
+    return &found -> second -> second;
+}
+
+tile_data& tile_cache::update(const tile_key& key, bool fractions, bool periods) {
+    auto found = index.find(key);
+    if(found != index.end()) {
+        tiles.splice(tiles.begin(), tiles, found -> second);
+        return found -> second -> second;
+    }
+    // New tile with all cells empty
+    int cells = CACHE_TILE * CACHE_TILE;
+    tiles.push_front(make_pair(key, tile_data()));
+    tile_data& data = tiles.front().second;
+    data.x.assign(cells, -1);
+    data.y.assign(cells, -1);
+    data.iterations.assign(cells, 0);
+    if(fractions) data.fractions.assign(cells, 0);
+    if(periods) data.periods.assign(cells, 0);
+    index[key] = tiles.begin();
+    memory_used += data.bytes();
+    evict();
+    return data;
+}
+
+void tile_cache::count(long long hits, long long misses) {
+    this -> hits += hits;
+    this -> misses += misses;
+}
+
+void tile_cache::clear() {
+    tiles.clear();
+    index.clear();
+    memory_used = 0;
+}
+
+int tile_cache::size() const {
+    return tiles.size();
+}
+
+size_t tile_cache::bytes() const {
+    return memory_used;
+}
+
+long long tile_cache::get_hits() const {
+    return hits;
+}
+
+long long tile_cache::get_misses() const {
+    return misses;
+}
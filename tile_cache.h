@@ -0,0 +1,95 @@
+#ifndef __TILE_CACHE_H__
+#define __TILE_CACHE_H__
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+using namespace std;
+
+// Tiles of the cache are squares of CACHE_TILE x CACHE_TILE cells (CACHE_TILE = 2^CACHE_TILE_BITS)
+const int CACHE_TILE_BITS = 5;
+const int CACHE_TILE = 1 << CACHE_TILE_BITS;
+
+// Key of a tile of the cache
+// Tiles form a grid fixed in the plane (not in the window), so every rendering at the same zoom which covers a tile
+// finds the points of the tile which earlier renderings iterated, whatever its view
+// Cells of the grid are the largest powers of 2 which are not larger than the distance between adjacent points (so every
+// cell holds at most one point of a rendering), and tiles are CACHE_TILE cells wide and high
+struct tile_key {
+    // Distance between adjacent points of the renderings using the tile (renderings at other zooms have their own
+    // tiles, so that they do not replace each other's points)
+    double spacing_x;
+    double spacing_y;
+    // Hash of the position of the tile (its corner with the smallest coordinates, a multiple of the size of the tile)
+    unsigned long long origin;
+    // Max number of iterations, and the kernel which found the iteration counts (algorithm, scalar type and the options
+    // which change the counts)
+    int max_iteration;
+    int kernel;
+    bool operator==(const tile_key& key) const;
+};
+
+// Hash function of tile keys (used by unordered_map)
+struct tile_key_hash {
+    size_t operator()(const tile_key& key) const;
+};
+
+// Points of a tile, one per cell, cell by cell row by row (fractions and periods are empty if the kernel does not find
+// them)
+struct tile_data {
+    // Position of the point in every cell, in cells from the corner of the tile (-1 if no point is saved in the cell)
+    vector<float> x;
+    vector<float> y;
+    vector<int> iterations;
+    vector<float> fractions;
+    vector<int> periods;
+    // Memory used by the buffers (in bytes)
+    size_t bytes() const;
+};
+
+// Cache of the points iterated by earlier renderings, so that a rendering covering them (after zooming out to a plot whose
+// colors were evicted from the stack, going back to an earlier precision, panning back, ...) does not iterate them again
+// Tiles are kept in order of use, and the least recently used ones are evicted when the memory budget is exceeded
+// It is only used between the passes of a rendering (not from the threads of the pool), so it needs no locking
+class tile_cache {
+
+private:
+    // Tiles with their keys, most recently used first
+    list<pair<tile_key, tile_data> > tiles;
+    // Position of every tile in the list
+    unordered_map<tile_key, list<pair<tile_key, tile_data> >::iterator, tile_key_hash> index;
+    // Memory which can be used by all tiles together, and memory used by them (in bytes)
+    size_t memory_budget;
+    size_t memory_used;
+    // Number of points found in the cache, and not found in it
+    long long hits;
+    long long misses;
+    // Function to evict the least recently used tiles till memory used is within the budget
+    // (the most recently used tile is never evicted, so a tile being updated stays in the cache)
+    void evict();
+
+public:
+    // Constructor (default memory budget is 64 MB)
+    tile_cache();
+    // Function to change the memory budget (in bytes)
+    void set_memory_budget(size_t memory_budget);
+    // Function to find a tile (returns null if it is not in the cache)
+    // The tile becomes the most recently used one; the pointer is valid till the next update
+    const tile_data* find(const tile_key& key);
+    // Function to return a tile to save points in, adding an empty tile (with fractions and periods, if they are
+    // needed) if it is not in the cache
+    // The tile becomes the most recently used one; the reference is valid till the next update
+    tile_data& update(const tile_key& key, bool fractions, bool periods);
+    // Function to count points found and not found in the cache
+    void count(long long hits, long long misses);
+    // Function to remove all tiles (counters are kept)
+    void clear();
+    // Number of tiles, and memory used by them (in bytes)
+    int size() const;
+    size_t bytes() const;
+    // Number of points found and not found since the cache was created
+    long long get_hits() const;
+    long long get_misses() const;
+};
+#endif // __TILE_CACHE_H__